@@ -73,8 +73,8 @@ int main(int argc, char* argv[]) {
 
     // auto translatedDF = translatedPut->value();
 
-    // std::cout << *translatedDF->getString(0, 0);
-    // std::cout << *translatedDF->getString(0, 1);
+    // std::cout << translatedDF->getString(0, 0);
+    // std::cout << translatedDF->getString(0, 1);
     // std::cout << translatedDF->getInt(1, 0);
     // std::cout << translatedDF->getInt(1, 1);
 
@@ -0,0 +1,67 @@
+// lang::Cpp
+/**
+ * @file bitmap.hpp
+ * @author Vincent Zhao, Michael Hebert
+ * @brief A growable sequence of bits packed 64 to a word.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Bits packed into 64-bit words, bit i is bit i % 64 of word i / 64.
+ * Bits past the end of the last word are always 0, so whole words can be
+ * counted and combined without masking. Used by bool Columns and for the
+ * row selections of filters.
+ */
+class Bitmap {
+   private:
+    std::vector<uint64_t> _words;  // packed bits
+    size_t _size;                  // number of bits
+
+   public:
+    // Number of bits in a word
+    static constexpr size_t WORD_BITS = 64;
+
+    // Creates an empty Bitmap
+    Bitmap();
+
+    // Creates a Bitmap of size bits, all set to value
+    explicit Bitmap(size_t size, bool value = false);
+
+    // Creates a Bitmap of size bits packed 8 to a byte, in the same order as
+    // the bytes of words()
+    Bitmap(const uint8_t* bytes, size_t size);
+
+    // Gets the bit at the given index
+    bool get(size_t idx) const;
+
+    // Sets the bit at the given index
+    void set(size_t idx, bool value);
+
+    // Adds a bit to the end
+    void push_back(bool value);
+
+    // Grows or shrinks to size bits, new bits are set to value
+    void resize(size_t size, bool value = false);
+
+    // Number of bits
+    size_t size() const;
+
+    // Number of set bits
+    size_t count() const;
+
+    // The packed words, size() bits rounded up to whole words
+    const uint64_t* words() const;
+    uint64_t* words();
+    size_t wordCount() const;
+
+    // Bitwise combinations with a Bitmap of the same size
+    Bitmap& operator&=(const Bitmap& other);
+    Bitmap& operator|=(const Bitmap& other);
+};
+
+Bitmap operator&(Bitmap a, const Bitmap& b);
+Bitmap operator|(Bitmap a, const Bitmap& b);
@@ -0,0 +1,79 @@
+// lang::Cpp
+/**
+ * @file boolcolumn.hpp
+ * @author Vincent Zhao, Michael Hebert
+ * @brief Column specialization storing bools as packed bits.
+ */
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+
+#include "bitmap.hpp"
+
+/**
+ * Column<bool>
+ *
+ * Stores its values in a Bitmap, 64 to a word, instead of a byte each.
+ * Counting and combining columns work on whole words at a time, and the
+ * column serializes as its item count followed by the packed bits.
+ * */
+template <>
+class Column<bool> : public ColumnInterface {
+   private:
+    Bitmap _bits;  // the values
+
+   public:
+    // construct a column
+    Column();
+
+    // Columns cannot be moved from their intial instantiation
+    Column(Column<bool>&& other) = delete;
+
+    // Columns cannot be copied
+    Column(const Column<bool>& other) = delete;
+
+    // Creates a column with the provided elements
+    Column(std::initializer_list<bool> ll);
+
+    // Creates a column holding the given bits
+    explicit Column(Bitmap bits);
+
+    // Get a value at the given index
+    bool get(size_t idx) const;
+
+    // Set value at idx. An out of bound idx is undefined
+    void set(size_t idx, bool val);
+
+    // Adds a value to the end of the column
+    void push_back(bool val);
+
+    // Adds a missing item to the end of the column
+    void pushMissing() override;
+
+    // Grows or shrinks the column, new items are false
+    void resize(size_t size);
+
+    // Number of true values
+    size_t count() const;
+
+    // The values as packed bits
+    const Bitmap& bits() const;
+
+    // Combines this column with another of the same size, item by item
+    void andWith(const Column<bool>& other);
+    void orWith(const Column<bool>& other);
+
+    /** Returns the number of elements in the column. */
+    size_t size() const override;
+
+    /** Returns the column as a string "1, 0, 1, 1" */
+    std::string str() const override;
+
+    //! Serializes the given Column
+    void serialize(Serializer& ss) const override;
+
+    //! Checks if the Column contains serializable types
+    bool canSerialize() const override;
+};
@@ -2,24 +2,42 @@
 /**
  * @file chunk.hpp
  * @author Vincent Zhao, Michael Hebert
- * @brief A wrapper for a fixed-size array used in Columns.
+ * @brief A fixed-size, cache-line aligned block of items used in Columns.
  */
 #pragma once
 
-#include <array>
+#include <cstddef>
 
 namespace {
-constexpr size_t CHUNK_SIZE = 10;  // Size per static array, adjustable
+constexpr size_t CACHE_LINE_SIZE = 64;     // Alignment of chunk storage
+constexpr size_t CHUNK_BYTES = 64 * 1024;  // Bytes per chunk, adjustable
+
+// Largest shift such that (1 << shift) items of the given size fit in a chunk
+constexpr size_t chunkShift(size_t itemSize) {
+    size_t shift = 0;
+    while ((static_cast<size_t>(2) << shift) * itemSize <= CHUNK_BYTES) shift++;
+    return shift;
+}
 }  // namespace
 
-// A fixed-size array of items
+// A fixed-size array of items living in memory owned by a Slab. The number of
+// items per chunk is chosen per type so that each chunk takes up CHUNK_BYTES,
+// and is always a power of two so that indexing is a shift and a mask.
 template <typename T>
 class Chunk {
    private:
-    std::array<T, CHUNK_SIZE> _data;
+    T* _data;  // items, constructed in place in externally owned memory
 
    public:
-    Chunk();
+    // log2 of the number of items in a chunk
+    static constexpr size_t SHIFT = chunkShift(sizeof(T));
+
+    // mask to get the index of an item within its chunk
+    static constexpr size_t MASK = (static_cast<size_t>(1) << SHIFT) - 1;
+
+    // Constructs all items of the chunk in the memory provided, which must be
+    // at least bytes() large and aligned to CACHE_LINE_SIZE
+    explicit Chunk(void* memory);
 
     // delete copy constructor
     Chunk(const Chunk&) = delete;
@@ -27,14 +45,28 @@ class Chunk {
     // move constructor
     Chunk(Chunk<T>&& other);
 
+    // Destroys the items, the memory itself is released by its owner
+    ~Chunk();
+
     // access element
     T& operator[](size_t idx);
+    const T& operator[](size_t idx) const;
 
     // access element with bounds checking
     T& at(size_t idx);
 
+    // pointer to the first item of the chunk
+    T* data();
+    const T* data() const;
+
     // get size
-    static size_t size() { return CHUNK_SIZE; };
+    static constexpr size_t size() { return MASK + 1; };
+
+    // bytes of memory needed to hold a chunk, rounded up to a cache line
+    static constexpr size_t bytes() {
+        return (size() * sizeof(T) + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE *
+               CACHE_LINE_SIZE;
+    }
 };
 
-#include "chunk.tpp"
\ No newline at end of file
+#include "chunk.tpp"
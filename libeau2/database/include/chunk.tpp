@@ -6,14 +6,30 @@
  */
 #pragma once
 
-#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
 
+// Trivial types are left uninitialized, everything else is value initialized
 template <typename T>
-inline Chunk<T>::Chunk() {}
+inline Chunk<T>::Chunk(void* memory) : _data(static_cast<T*>(memory)) {
+    if constexpr (!std::is_trivially_default_constructible_v<T>) {
+        std::uninitialized_value_construct_n(_data, size());
+    }
+}
 
 // move constructor
 template <typename T>
-inline Chunk<T>::Chunk(Chunk<T>&& other) : _data(std::move(other._data)) {}
+inline Chunk<T>::Chunk(Chunk<T>&& other) : _data(other._data) {
+    other._data = nullptr;
+}
+
+template <typename T>
+inline Chunk<T>::~Chunk() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        if (_data) std::destroy_n(_data, size());
+    }
+}
 
 // access element
 template <typename T>
@@ -21,8 +37,24 @@ inline T& Chunk<T>::operator[](size_t idx) {
     return _data[idx];
 }
 
+template <typename T>
+inline const T& Chunk<T>::operator[](size_t idx) const {
+    return _data[idx];
+}
+
 // access element with bounds checking
 template <typename T>
 inline T& Chunk<T>::at(size_t idx) {
-    return _data.at(idx);
-}
\ No newline at end of file
+    if (idx >= size()) throw std::out_of_range("Chunk index out of range");
+    return _data[idx];
+}
+
+template <typename T>
+inline T* Chunk<T>::data() {
+    return _data;
+}
+
+template <typename T>
+inline const T* Chunk<T>::data() const {
+    return _data;
+}
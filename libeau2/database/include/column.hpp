@@ -9,23 +9,55 @@
 #include <array>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "chunk.hpp"
+#include "encoding.hpp"
+#include "slab.hpp"
+#include "span.hpp"
+#include "validity.hpp"
 
 class Serializer;
 
 /**
  * @brief A common interface representing a Column, allows for different Column
- * types to be stored within the same STL containers.
+ * types to be stored within the same STL containers. Every Column also tracks
+ * which of its items are missing.
  */
 class ColumnInterface {
+   protected:
+    Validity _validity;  // which items are present
+
    public:
     virtual ~ColumnInterface(){};
 
+    /** Adds a missing item to the end of the column. */
+    virtual void pushMissing() = 0;
+
+    /** Marks the item at the given index as missing, setting it again makes
+     * it present. */
+    void setMissing(size_t idx) { _validity.set(idx, false); }
+
+    /** Whether the item at the given index is missing. */
+    bool isMissing(size_t idx) const { return _validity.isMissing(idx); }
+
+    /** Number of missing items in the column. */
+    size_t nullCount() const { return _validity.nullCount(); }
+
+    /** Which items of the column are present. */
+    const Validity& validity() const { return _validity; }
+
+    /** Replaces which items are present, the bitmap must match size(). */
+    void setValidity(Bitmap present) { _validity.assign(std::move(present)); }
+
     /** Returns the number of elements in the column. */
     virtual size_t size() const = 0;
 
+    /** Encodes the column's items if its type supports it, see
+     * Column<T>::seal(). Other columns are left as they are. */
+    virtual void seal() {}
+
     /** Returns the column as a string "1, 2, 3, 4" */
     virtual std::string str() const = 0;
 
@@ -46,8 +78,33 @@ class ColumnInterface {
 template <typename T>
 class Column : public ColumnInterface {
    private:
-    std::vector<std::shared_ptr<Chunk<T>>> _data;  // vector of chunks
-    size_t _size;  // number of items in the column
+    std::shared_ptr<void> _backing;  // external memory holding some chunks
+    Slab _slab;                      // backing memory for the chunks
+    std::vector<Chunk<T>> _data;     // chunks after the encoded ones
+    size_t _size;                    // number of items in the column
+    std::vector<EncodedChunk<T>> _encoded;  // leading chunks, encoded
+    bool _sealed = false;  // whether chunks are encoded as they fill
+    std::vector<void*> _spare;  // memory of chunks since encoded, reused
+
+    // Memory for a new chunk
+    void* _allocate();
+
+    // Encodes the given number of leading plain chunks
+    void _encodePlain(size_t count);
+
+    // Encodes the full chunks of a sealed column that are still plain
+    void _encodeFull();
+
+    // Makes the partial last chunk of a sealed column plain again, so that
+    // items can be added to it
+    void _reopenTail();
+
+    // Decodes a sealed column back into chunks
+    void _unseal();
+
+    // The items [offset, offset + len) of the encoded chunk at the given
+    // index, decoded into memory owned by the Block
+    Block<T> _decode(size_t chunkIdx, size_t offset, size_t len) const;
 
    public:
     // construct a column
@@ -62,6 +119,12 @@ class Column : public ColumnInterface {
     // Creates a column with the provided elements
     Column(std::initializer_list<T> ll);
 
+    // Creates a column of size items stored in whole chunks laid out back to
+    // back at data, each Chunk<T>::bytes() long and cache line aligned. The
+    // items are used in place, backing keeps their memory alive. Trivial
+    // types only.
+    Column(std::shared_ptr<void> backing, void* data, size_t size);
+
     // Get a value at the given index
     T get(size_t idx) const;
 
@@ -71,6 +134,59 @@ class Column : public ColumnInterface {
     // Adds a value to the end of the column
     void push_back(T val);
 
+    // Adds a missing item to the end of the column
+    void pushMissing() override;
+
+    // Adds count values to the end of the column, copying a chunk at a time
+    void append(const T* vals, size_t count);
+
+    // Adds count values stored at bytes, which need not be aligned
+    void appendBytes(const uint8_t* bytes, size_t count);
+
+    // Grows or shrinks the column to the given number of items. Grown items
+    // of trivial types are left uninitialized and must be set before use.
+    void resize(size_t size);
+
+    // Number of contiguous Blocks the column is stored in
+    size_t blocks() const;
+
+    // The filled part of the chunk at the given index as a contiguous Block
+    Block<T> block(size_t chunkIdx) const;
+
+    // Writable storage of the chunk at the given index, for filling in the
+    // items of a resized column in place. A sealed column is decoded first.
+    T* chunkData(size_t chunkIdx);
+
+    // The items [start, start + len) as a Block, must lie within one chunk
+    Block<T> slice(size_t start, size_t len) const;
+
+    // Encodes every chunk of a signed integer column in the smallest
+    // IntEncoding and frees the chunks, then keeps encoding chunks as
+    // appending fills them. Other columns are left as they are. Blocks of
+    // encoded chunks are decoded each time they are asked for, changing the
+    // column other than by appending decodes it entirely.
+    void seal() override;
+
+    // Whether the column encodes its chunks
+    bool sealed() const;
+
+    // The encoded chunk at the given index of a sealed column, only a
+    // partial last chunk may not be encoded
+    const EncodedChunk<T>& encodedChunk(size_t chunkIdx) const;
+
+    // Adds up to a chunk of encoded items to the end of the column. An empty
+    // or sealed column of whole chunks keeps them encoded, otherwise they
+    // are decoded and appended.
+    void appendEncoded(EncodedChunk<T> chunk);
+
+    // Bytes used to store the items, encoded or not
+    size_t itemBytes() const;
+
+    // Calls f(item) for every item in order. Sealed chunks are decoded as
+    // they are scanned, without being written out.
+    template <typename F>
+    void forEach(F f) const;
+
     /** Returns the number of elements in the column. */
     size_t size() const override;
 
@@ -84,4 +200,6 @@ class Column : public ColumnInterface {
     bool canSerialize() const override;
 };
 
-#include "column.tpp"
\ No newline at end of file
+#include "column.tpp"
+#include "boolcolumn.hpp"
+#include "stringcolumn.hpp"
\ No newline at end of file
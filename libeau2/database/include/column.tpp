@@ -6,23 +6,30 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <sstream>
+#include <type_traits>
+#include <utility>
 
 #include "payload.hpp"
+#include "serializer.hpp"
 
 namespace {}  // namespace
 
 // construct a column
 template <typename T>
-Column<T>::Column() : _size(0) {}
+Column<T>::Column()
+    : _slab(Chunk<T>::bytes(), CACHE_LINE_SIZE), _size(0) {}
 
 // Creates a column with the provided elements
 template <typename T>
-Column<T>::Column(std::initializer_list<T> ll) : _size(0) {
-    size_t chunkedSize = ll.size() / Chunk<T>::size();
-    if (ll.size() % Chunk<T>::size()) chunkedSize++;
+Column<T>::Column(std::initializer_list<T> ll) : Column() {
+    size_t chunkedSize = ll.size() >> Chunk<T>::SHIFT;
+    if (ll.size() & Chunk<T>::MASK) chunkedSize++;
     _data.reserve(chunkedSize);
 
     for (const T& e : ll) {
@@ -30,36 +37,288 @@ Column<T>::Column(std::initializer_list<T> ll) : _size(0) {
     }
 }
 
+// The chunks keep pointing into the external memory, chunks added later come
+// from the Slab as usual
+template <typename T>
+Column<T>::Column(std::shared_ptr<void> backing, void* data, size_t size)
+    : Column() {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivial items can be used in place");
+
+    _backing = std::move(backing);
+    size_t chunks = (size + Chunk<T>::MASK) >> Chunk<T>::SHIFT;
+    _data.reserve(chunks);
+    for (size_t ii = 0; ii < chunks; ii++) {
+        _data.emplace_back(static_cast<uint8_t*>(data) +
+                           ii * Chunk<T>::bytes());
+    }
+
+    _size = size;
+    _validity.resize(size);
+}
+
 // Get a value at the given index
 template <typename T>
 T Column<T>::get(size_t idx) const {
-    size_t chunkIdx = idx / Chunk<T>::size();
-    size_t itemIdx = idx % Chunk<T>::size();
-
-    return (*_data[chunkIdx])[itemIdx];
+    size_t chunkIdx = idx >> Chunk<T>::SHIFT;
+    if (chunkIdx < _encoded.size()) {
+        return _encoded[chunkIdx].get(idx & Chunk<T>::MASK);
+    }
+    return _data[chunkIdx - _encoded.size()][idx & Chunk<T>::MASK];
 }
 
 // Set value at idx. An out of bound idx is undefined
 template <typename T>
 void Column<T>::set(size_t idx, T val) {
+    if (_sealed) _unseal();
     // same logic as get for index logic
-    size_t chunkIdx = idx / Chunk<T>::size();
-    size_t itemIdx = idx % Chunk<T>::size();
-
-    (*_data[chunkIdx])[itemIdx] = val;
+    _data[idx >> Chunk<T>::SHIFT][idx & Chunk<T>::MASK] = val;
+    _validity.set(idx, true);
 }
 
 // Adds a value to the end of the column
 template <typename T>
 void Column<T>::push_back(T val) {
-    size_t chunkIdx;
-    size_t itemIdx = _size++ % Chunk<T>::size();
+    _reopenTail();
+    size_t itemIdx = _size++ & Chunk<T>::MASK;
     if (itemIdx == 0) {
-        _data.push_back(std::make_shared<Chunk<T>>());
+        _data.emplace_back(_allocate());
+    }
+
+    _data.back()[itemIdx] = std::move(val);
+    _validity.push_back(true);
+    if (itemIdx == Chunk<T>::MASK) _encodeFull();
+}
+
+// Missing items hold a value initialized T
+template <typename T>
+void Column<T>::pushMissing() {
+    push_back(T());
+    _validity.set(_size - 1, false);
+}
+
+// Adds count values to the end of the column, copying a chunk at a time. A
+// sealed column encodes every chunk filled before the next one is allocated.
+template <typename T>
+void Column<T>::append(const T* vals, size_t count) {
+    _reopenTail();
+
+    while (count) {
+        size_t offset = _size & Chunk<T>::MASK;
+        size_t len = std::min(count, Chunk<T>::size() - offset);
+        if (offset == 0) _data.emplace_back(_allocate());
+        std::copy(vals, vals + len, &_data.back()[offset]);
+
+        _size += len;
+        if (offset + len == Chunk<T>::size()) _encodeFull();
+        vals += len;
+        count -= len;
+    }
+    _validity.resize(_size);
+}
+
+template <typename T>
+void Column<T>::appendBytes(const uint8_t* bytes, size_t count) {
+    _reopenTail();
+
+    while (count) {
+        size_t offset = _size & Chunk<T>::MASK;
+        size_t len = std::min(count, Chunk<T>::size() - offset);
+        if (offset == 0) _data.emplace_back(_allocate());
+        memcpy(&_data.back()[offset], bytes, len * sizeof(T));
+
+        _size += len;
+        if (offset + len == Chunk<T>::size()) _encodeFull();
+        bytes += len * sizeof(T);
+        count -= len;
+    }
+    _validity.resize(_size);
+}
+
+// Chunks past the new end are dropped, their memory stays with the Slab
+template <typename T>
+void Column<T>::resize(size_t size) {
+    if (_sealed) _unseal();
+    size_t chunks = (size + Chunk<T>::MASK) >> Chunk<T>::SHIFT;
+
+    while (_data.size() > chunks) _data.pop_back();
+
+    _data.reserve(chunks);
+    while (_data.size() < chunks) _data.emplace_back(_allocate());
+
+    _size = size;
+    _validity.resize(size);
+}
+
+// Number of contiguous Blocks the column is stored in
+template <typename T>
+size_t Column<T>::blocks() const {
+    return _encoded.size() + _data.size();
+}
+
+// Every chunk is full except possibly the last one
+template <typename T>
+Block<T> Column<T>::block(size_t chunkIdx) const {
+    size_t start = chunkIdx << Chunk<T>::SHIFT;
+    size_t len = std::min(Chunk<T>::size(), _size - start);
+
+    if (chunkIdx < _encoded.size()) return _decode(chunkIdx, 0, len);
+    return Block<T>(_data[chunkIdx - _encoded.size()].data(), len);
+}
+
+template <typename T>
+T* Column<T>::chunkData(size_t chunkIdx) {
+    if (_sealed) _unseal();
+    return _data[chunkIdx].data();
+}
+
+// The items [start, start + len) as a Block, must lie within one chunk
+template <typename T>
+Block<T> Column<T>::slice(size_t start, size_t len) const {
+    assert(len == 0 || (start >> Chunk<T>::SHIFT) ==
+                           ((start + len - 1) >> Chunk<T>::SHIFT));
+    assert(start + len <= _size);
+
+    if (len == 0) return Block<T>(nullptr, 0);
+
+    size_t chunkIdx = start >> Chunk<T>::SHIFT;
+    if (chunkIdx < _encoded.size()) {
+        return _decode(chunkIdx, start & Chunk<T>::MASK, len);
     }
+    return Block<T>(&_data[chunkIdx - _encoded.size()][start & Chunk<T>::MASK],
+                    len);
+}
 
-    chunkIdx = _data.size() - 1;
-    (*_data[chunkIdx])[itemIdx] = val;
+// Once every chunk is encoded, the memory of the plain ones is freed
+template <typename T>
+void Column<T>::seal() {
+    if constexpr (isEncodable<T>()) {
+        _sealed = true;
+        _encodePlain(_data.size());
+        _spare.clear();
+        _slab.clear();
+        _backing.reset();
+    }
+}
+
+template <typename T>
+bool Column<T>::sealed() const {
+    return _sealed;
+}
+
+template <typename T>
+const EncodedChunk<T>& Column<T>::encodedChunk(size_t chunkIdx) const {
+    return _encoded[chunkIdx];
+}
+
+// Every chunk of a sealed column is encoded once it ends on a whole chunk
+template <typename T>
+void Column<T>::appendEncoded(EncodedChunk<T> chunk) {
+    bool whole = !(_size & Chunk<T>::MASK);
+    if ((!_size || _sealed) && whole && chunk.size() <= Chunk<T>::size()) {
+        _sealed = true;
+        _size += chunk.size();
+        _validity.resize(_size);
+        _encoded.push_back(std::move(chunk));
+    } else {
+        std::vector<T> items(chunk.size());
+        chunk.decodeTo(items.data());
+        append(items.data(), items.size());
+    }
+}
+
+template <typename T>
+size_t Column<T>::itemBytes() const {
+    size_t bytes = _data.size() * Chunk<T>::bytes();
+    for (const EncodedChunk<T>& chunk : _encoded) bytes += chunk.bytes();
+    return bytes;
+}
+
+template <typename T>
+template <typename F>
+void Column<T>::forEach(F f) const {
+    for (const EncodedChunk<T>& chunk : _encoded) chunk.forEach(f);
+
+    for (size_t ii = _encoded.size(); ii < blocks(); ii++) {
+        for (const T& item : block(ii)) f(item);
+    }
+}
+
+// Chunks encoded while sealed hand their memory on to the next ones, unless
+// it is external
+template <typename T>
+void* Column<T>::_allocate() {
+    if (_spare.empty()) return _slab.allocate();
+
+    void* memory = _spare.back();
+    _spare.pop_back();
+    return memory;
+}
+
+template <typename T>
+void Column<T>::_encodePlain(size_t count) {
+    for (size_t ii = 0; ii < count; ii++) {
+        size_t start = _encoded.size() << Chunk<T>::SHIFT;
+        size_t len = std::min(Chunk<T>::size(), _size - start);
+        _encoded.push_back(EncodedChunk<T>::encode(_data[ii].data(), len));
+        if (!_backing) _spare.push_back(_data[ii].data());
+    }
+
+    if (count == _data.size()) {
+        _data.clear();
+        return;
+    }
+    std::vector<Chunk<T>> rest;
+    rest.reserve(_data.size() - count);
+    for (size_t ii = count; ii < _data.size(); ii++) {
+        rest.push_back(std::move(_data[ii]));
+    }
+    _data = std::move(rest);
+}
+
+// Encoded chunks are all full while there are plain ones after them
+template <typename T>
+void Column<T>::_encodeFull() {
+    if constexpr (isEncodable<T>()) {
+        if (_sealed) _encodePlain((_size >> Chunk<T>::SHIFT) - _encoded.size());
+    }
+}
+
+template <typename T>
+void Column<T>::_reopenTail() {
+    if (!_data.empty() || _encoded.empty() || !(_size & Chunk<T>::MASK)) {
+        return;
+    }
+
+    _data.emplace_back(_allocate());
+    _encoded.back().decodeTo(_data.back().data());
+    _encoded.pop_back();
+}
+
+template <typename T>
+void Column<T>::_unseal() {
+    std::vector<EncodedChunk<T>> encoded = std::move(_encoded);
+    std::vector<Chunk<T>> plain = std::move(_data);
+    _encoded.clear();
+    _data.clear();
+    _sealed = false;
+
+    _data.reserve(encoded.size() + plain.size());
+    for (const EncodedChunk<T>& chunk : encoded) {
+        _data.emplace_back(_allocate());
+        chunk.decodeTo(_data.back().data());
+    }
+    for (Chunk<T>& chunk : plain) _data.push_back(std::move(chunk));
+}
+
+// Nothing decoded is kept, so several threads can decode the same chunk at
+// once and scanning a column only ever holds a chunk of it decoded per Block
+template <typename T>
+Block<T> Column<T>::_decode(size_t chunkIdx, size_t offset, size_t len) const {
+    const EncodedChunk<T>& chunk = _encoded[chunkIdx];
+    std::shared_ptr<T[]> items(new T[chunk.size()]);
+    chunk.decodeTo(items.get());
+    return Block<T>(items, items.get() + offset, len);
 }
 
 /** Returns the number of elements in the column. */
@@ -83,12 +342,68 @@ std::string Column<T>::str() const {
     return ss.str();
 }
 
-// Encodes Column in Payload format and adds to Serializer
+// Encodes Column in Payload format and adds to Serializer. Sealed signed
+// integer columns are sent as an Encoded Payload when that is smaller: the
+// item type, the number of chunks, then the IntEncoding, item count, length
+// and bytes of each chunk. Only a partial last chunk is encoded here, the
+// others are referenced as they are. Unsealed columns are sent as plain
+// items rather than encoded again on every send.
 template <typename T>
 void Column<T>::serialize(Serializer& ss) const {
-    Payload colData;
-    for (size_t ii = 0; ii < size(); ii++) colData.add(get(ii));
-    colData.serialize(ss);
+    if constexpr (isEncodable<T>()) {
+        std::vector<EncodedChunk<T>> tail;
+        for (size_t ii = _encoded.size(); _sealed && ii < blocks(); ii++) {
+            Block<T> items = block(ii);
+            tail.push_back(EncodedChunk<T>::encode(items.data(), items.size()));
+        }
+
+        size_t bytes = sizeof(uint8_t) + sizeof(uint64_t);
+        for (const EncodedChunk<T>& chunk : _encoded) {
+            bytes += Serial::ENCODED_CHUNK_HDR_SIZE + chunk.bytes();
+        }
+        for (const EncodedChunk<T>& chunk : tail) {
+            bytes += Serial::ENCODED_CHUNK_HDR_SIZE + chunk.bytes();
+        }
+
+        if (_sealed && bytes < size() * sizeof(T)) {
+            Payload::serializeHeader(ss, Serial::Type::Encoded, 0, bytes);
+            ss.add(Serial::typeToValue(Serial::isType(T())))
+                .add(static_cast<uint64_t>(blocks()));
+
+            auto addHeader = [&ss](const EncodedChunk<T>& chunk) {
+                ss.add(static_cast<uint8_t>(chunk.encoding()))
+                    .add(static_cast<uint32_t>(chunk.size()))
+                    .add(static_cast<uint64_t>(chunk.bytes()));
+            };
+            for (const EncodedChunk<T>& chunk : _encoded) {
+                addHeader(chunk);
+                ss.addRef(chunk.data(), chunk.bytes());
+            }
+            for (const EncodedChunk<T>& chunk : tail) {
+                addHeader(chunk);
+                ss.addBytes(chunk.data(), chunk.bytes());
+            }
+            return;
+        }
+    }
+
+    if constexpr (std::is_arithmetic_v<T>) {
+        Payload::serializeHeader(ss, Serial::isType(T()), 0,
+                                 size() * sizeof(T));
+        // Decoded Blocks don't outlive the call
+        for (size_t ii = 0; ii < blocks(); ii++) {
+            Block<T> items = block(ii);
+            if (ii < _encoded.size()) {
+                ss.addBytes(items.data(), items.size() * sizeof(T));
+            } else {
+                ss.addRef(items.data(), items.size() * sizeof(T));
+            }
+        }
+    } else {
+        Payload colData;
+        for (size_t ii = 0; ii < size(); ii++) colData.add(get(ii));
+        colData.serialize(ss);
+    }
 }
 
 // Makes sure the Column is not empty and contains a trivially serializable type
@@ -0,0 +1,119 @@
+// lang::Cpp
+/**
+ * @file columnfile.hpp
+ * @author Vincent Zhao, Michael Hebert
+ * @brief Binary columnar files DataFrames can be saved to and mapped from.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "commondefs.hpp"
+
+/**
+ * @brief A DataFrame saved in eau2's binary columnar format, mapped into
+ * memory. The file starts with a header and the type and location of every
+ * column, followed by the columns' sections, each aligned to a cache line:
+ *
+ * - int and double columns are stored as whole Chunks, as they are in a
+ *   Column, and are used in place without being copied
+ * - bool columns are stored as their packed bits
+ * - string columns are stored as their arena of NUL terminated strings and
+ *   the chunks of their offsets, only the arena is copied
+ * - the validity bitmap of any column with missing items
+ * - optionally the min and max of every chunk of int and double columns,
+ *   not counting missing items
+ *
+ * The mapping is private, so the loaded DataFrame can be modified without
+ * changing the file. Numbers are stored in the byte order of the machine.
+ */
+class ColumnFile {
+   public:
+    // Layout of the start of the file
+    struct Header {
+        char magic[8];     // MAGIC
+        uint64_t version;  // VERSION
+        uint64_t rows;     // number of rows
+        uint64_t cols;     // number of ColumnHeaders that follow
+    };
+
+    // Layout of the description of each column
+    struct ColumnHeader {
+        char type;               // schema type of the column
+        uint8_t hasStats;        // whether chunk min and max were written
+        uint8_t unused[6];       // padding, 0
+        uint64_t data;           // offset of the items
+        uint64_t dataBytes;      // length of the items
+        uint64_t validity;       // offset of the validity bitmap words
+        uint64_t validityBytes;  // length of the bitmap, 0 if none missing
+        uint64_t arena;          // offset of the string arena
+        uint64_t arenaBytes;     // length of the string arena
+        uint64_t stats;          // offset of min, max double pairs
+    };
+
+    static constexpr char MAGIC[8] = {'E', 'A', 'U', '2', 'C', 'O', 'L', 0};
+    static constexpr uint64_t VERSION = 1;
+
+   private:
+    std::shared_ptr<void> _map;    // the mapped file, unmapped when released
+    size_t _size = 0;              // length of the file
+    const Header* _header = nullptr;         // start of the file
+    const ColumnHeader* _columns = nullptr;  // description of each column
+
+    // Checks that the header and every section lie within the file
+    bool _validate();
+
+   public:
+    /**
+     * @brief Maps the file with the given name. Check isOpen() for failures.
+     *
+     * @param filename
+     */
+    explicit ColumnFile(const char* filename);
+
+    /**
+     * @brief Writes a local DataFrame to a file in this format.
+     *
+     * @param df        the DataFrame, with int, double, bool and string
+     *                  columns only
+     * @param filename
+     * @param stats     whether to store the min and max of every chunk
+     * @return true if the file was written
+     */
+    static bool write(DataFrame& df, const char* filename, bool stats = true);
+
+    // Whether the file was mapped and is in this format
+    bool isOpen() const;
+
+    // Number of rows
+    size_t nrows() const;
+
+    // Number of columns
+    size_t ncols() const;
+
+    // Schema type of the column at idx
+    char colType(size_t idx) const;
+
+    /**
+     * @brief The min and max of the chunk at index chunk of an int or double
+     * column, if they were written. A chunk without present items has a min
+     * greater than its max.
+     *
+     * @param col
+     * @param chunk
+     * @param min
+     * @param max
+     * @return true if the range is known
+     */
+    bool chunkRange(size_t col, size_t chunk, double& min, double& max) const;
+
+    /**
+     * @brief A DataFrame over the mapped columns. It keeps the mapping alive
+     * after this ColumnFile is gone.
+     *
+     * @return DFPtr    the DataFrame, nullptr if the file is not open
+     */
+    DFPtr dataFrame() const;
+};
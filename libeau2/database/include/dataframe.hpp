@@ -9,17 +9,21 @@
 #pragma once
 
 #include <cstddef>
+#include <functional>
 #include <memory>
+#include <string_view>
 #include <vector>
 
 #include "commondefs.hpp"
 #include "schema.hpp"
+#include "span.hpp"
 
 class ColumnInterface;
 class KVStore;
 class Key;
 class Row;
 class Rower;
+class RowBatch;
 namespace ne {
 class ColumnSet;
 }
@@ -42,21 +46,35 @@ class DataFrame {
     size_t
         _blkSize;  // Size of each keyed DataFrame block for remote DataFrames
 
-    // Returns the value as the type specified, throws exception if invalid
+    // Returns the value as the column of the type specified does, throws
+    // exception if invalid
     template <typename T>
-    T getVal(size_t col, size_t row);
+    auto getVal(size_t col, size_t row);
 
     // gives Payload access to private fields for serialization
     friend class Payload;
 
+    // gives ColumnFile access to the columns to write and map them
+    friend class ColumnFile;
+
     template <typename T>
     static void fillColumn(ColPtr<T> col, T* arr, size_t size);
 
+    // Runs the Rower over every batch in parallel, calling after (if set) on
+    // each batch once the Rower is done with it, then joins the clones
+    void _mapBatches(Rower& r, const std::function<void(RowBatch&)>& after);
+
+    // Adds an already filled Column of the given schema type, sealing it
+    void _adoptCol(char type, ColIPtr col);
+
     // Used for filling remote DataFrame directories
     template <typename T>
     void _addRemoteCol(ColPtr<T> col);
 
    public:
+    // Default number of rows in each block of a remote DataFrame
+    static constexpr size_t BLOCK_ROWS = 1 << 16;
+
     // Creates an empty DataFrame
     DataFrame();
 
@@ -86,7 +104,8 @@ class DataFrame {
 
     /** Adds a column this dataframe, updates the schema, the new column
      * is external, and appears as the last column of the dataframe, the
-     * name is optional and external. A nullptr colum is undefined. */
+     * name is optional and external. The column is sealed. A nullptr colum
+     * is undefined. */
     template <typename T>
     void addCol(ColPtr<T> col, ExtString name = nullptr);
 
@@ -98,7 +117,18 @@ class DataFrame {
 
     double getDouble(size_t col, size_t row);
 
-    ExtString getString(size_t col, size_t row);
+    // The string is viewed in place, valid until the column is modified
+    std::string_view getString(size_t col, size_t row);
+
+    /** Whether the value at the given column and row is missing, missing
+     * values read as the type's default. */
+    bool isMissing(size_t col, size_t row);
+
+    /** Returns a typed view of the column at the given index, made up of
+     * contiguous Blocks that can be scanned without a cast or virtual call
+     * per item. Throws if the column is not of the requested type. */
+    template <typename T>
+    ColumnSpan<T> column(size_t col);
 
     /** Set the value at the given column and row to the given value.
      * If the column is not  of the right type or the indices are out of
@@ -126,8 +156,10 @@ class DataFrame {
     void map(Rower& r);
 
     /** Create a new dataframe, constructed from rows for which the given Rower
-     * returned true from its accept method. */
-    DataFrame& filter(Rower& r);
+     * returned true from its accept method. The predicate is evaluated in
+     * parallel like pmap, and the surviving rows are copied column by
+     * column. */
+    DFPtr filter(Rower& r);
 
     /** This method clones the Rower and executes the map in parallel. Join is
      * used at the end to merge the results. */
@@ -159,27 +191,46 @@ class DataFrame {
     static void fromScalar(Key* key, KVStore* kv, T value);
 
     /**
-     * @brief Creates a database from 4500ne's parsers. There's some data
-     * overhead that would be solved by refactoring our code or theirs to share
-     * the same column types.
+     * @brief Creates a database from 4500ne's parsers. Each column is copied
+     * straight out of its arrays and then freed, so only one column is held
+     * twice at a time.
      *
      * @param key   the key in the store
      * @param kv    the store
-     * @param set   the set of columns
+     * @param set   the set of columns, left without columns
      */
     static void fromColumnSet(Key* key, KVStore* kv, ne::ColumnSet* set);
 
     /**
-     * @brief Creates a remote DataFrame out of a SoRer file and distributes
-     * local blocks across KV store
+     * @brief Loads a SoRer file into a DataFrame and stores it in the KV store
+     * at the key provided. The file is memory mapped and parsed in parallel,
+     * FLOAT columns are loaded as doubles.
      *
      * @param filename
      * @param key
-     * @param kv
-     * @return DFPtr
+     * @param kv    the store, nullptr to only load the file
+     * @return DFPtr    the loaded DataFrame, nullptr if the file can't be read
      */
     static DFPtr fromFile(const char* filename, const Key& key, KVStore* kv);
 
+    /**
+     * @brief Loads a SoRer file into a remote DataFrame, streaming it in
+     * blocks of rows. Each block is pushed to its home node as soon as it is
+     * parsed, while later blocks are still being parsed, and only a few blocks
+     * are held on this node at a time, counting blocks still being sent.
+     * Block i is stored at "<key>_<i>" on node 1 + i % nodes. The directory
+     * is kept on this node.
+     *
+     * @param filename
+     * @param key       the key of the directory, homed on this node
+     * @param kv        the store
+     * @param nodes     the number of nodes blocks are spread over
+     * @param blockRows the number of rows in each block
+     * @return DFPtr    the remote DataFrame, nullptr if the file can't be read
+     */
+    static DFPtr streamFile(const char* filename, const Key& key, KVStore& kv,
+                            size_t nodes, size_t blockRows = BLOCK_ROWS);
+
     /**
      * @brief Mostly for debugging.
      *
@@ -13,29 +13,45 @@
 
 /** Adds a column this dataframe, updates the schema, the new column
  * is external, and appears as the last column of the dataframe, the
- * name is optional and external. A nullptr colum is undefined. */
+ * name is optional and external. The column is sealed. A nullptr colum is
+ * undefined. */
 template <typename T>
 inline void DataFrame::addCol(ColPtr<T> col, ExtString name) {
     if (_local) {
-        if (_schema.addCol(*col, name))
+        if (_schema.addCol(*col, name)) {
+            col->seal();
             _data.push_back(col);
-        else
+        } else {
             throw std::invalid_argument("col");
+        }
     } else {
         _addRemoteCol(col);
     }
 }
 
 template <typename T>
-inline T DataFrame::getVal(size_t col, size_t row) {
+inline auto DataFrame::getVal(size_t col, size_t row) {
     // cast column interface down to correct type
-    auto dfcol = std::dynamic_pointer_cast<Column<T>>(_data.at(col));
+    auto dfcol = dynamic_cast<const Column<T>*>(_data.at(col).get());
 
     if (!dfcol) throw std::runtime_error("Attempted to getVal as wrong type");
 
     return dfcol->get(row);
 }
 
+/** Returns a typed view of the column at the given index, made up of
+ * contiguous Blocks that can be scanned without a cast or virtual call
+ * per item. Throws if the column is not of the requested type. */
+template <typename T>
+inline ColumnSpan<T> DataFrame::column(size_t col) {
+    auto dfcol = std::dynamic_pointer_cast<Column<T>>(_data.at(col));
+
+    if (!dfcol)
+        throw std::runtime_error("Attempted to view column as wrong type");
+
+    return ColumnSpan<T>(dfcol);
+}
+
 /** Set the value at the given column and row to the given value.
  * If the column is not  of the right type or the indices are out of
  * bound, the result is undefined. */
@@ -0,0 +1,107 @@
+// lang::Cpp
+/**
+ * @file encoding.hpp
+ * @author Vincent Zhao, Michael Hebert
+ * @brief Lightweight compression of one chunk of integers.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// How the items of an EncodedChunk are stored
+enum class IntEncoding : uint8_t {
+    Plain = 0,             // the items as they are
+    RunLength = 1,         // a value and where its run ends, for every run
+    Delta = 2,             // differences to the previous item, bit packed
+    FrameOfReference = 3,  // differences to the smallest item, bit packed
+};
+
+// Whether Columns of the type can be encoded
+template <typename T>
+constexpr bool isEncodable() {
+    return std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) >= 4;
+}
+
+/**
+ * @brief Up to one Chunk of integers, stored in whichever encoding takes
+ * the least space:
+ *
+ * - RunLength: every run's value, followed by the uint32_t index its run ends
+ *   at. Lookups are a binary search over the ends.
+ * - FrameOfReference: the smallest item as an int64_t, the bit width as a
+ *   uint64_t, then every item minus the smallest packed into that many bits.
+ * - Delta: the first item and the smallest difference between neighbours as
+ *   int64_t, the bit width as a uint64_t, the value of every
+ *   DELTA_CHECKPOINT-th item as int64_t so lookups don't start from the
+ *   first item, then every difference minus the smallest one packed into
+ *   that many bits.
+ *
+ * Bits are packed from the least significant bit of 64-bit words, followed
+ * by a spare word so that they can always be read a word ahead. Sorted and
+ * small range columns shrink the most, columns that don't compress are kept
+ * Plain.
+ */
+template <typename T>
+class EncodedChunk {
+   private:
+    IntEncoding _encoding = IntEncoding::Plain;  // how _words are laid out
+    size_t _size = 0;                            // number of items
+    size_t _length = 0;                          // bytes of encoded items
+    std::vector<uint64_t> _words;  // encoded items, in words for alignment
+
+   public:
+    // Items between the absolute values stored by Delta encoded chunks
+    static constexpr size_t DELTA_CHECKPOINT = 128;
+
+    EncodedChunk();
+
+    /**
+     * @brief Encodes the items given, choosing the smallest encoding. Only
+     * types for which isEncodable() holds can be encoded.
+     *
+     * @param items
+     * @param size  number of items, at most a Chunk's worth
+     * @return EncodedChunk
+     */
+    static EncodedChunk encode(const T* items, size_t size);
+
+    /**
+     * @brief Rebuilds an encoded chunk from its encoding and bytes, as
+     * returned by encoding() and data().
+     *
+     * @param encoding
+     * @param size      number of items
+     * @param bytes
+     * @param length    number of bytes
+     * @param chunk     set to the chunk if the bytes are valid
+     * @return true if the bytes are a valid encoding of size items
+     */
+    static bool decode(IntEncoding encoding, size_t size, const uint8_t* bytes,
+                       size_t length, EncodedChunk& chunk);
+
+    // How the items are stored
+    IntEncoding encoding() const;
+
+    // Number of items
+    size_t size() const;
+
+    // The encoded items and their length in bytes
+    const uint8_t* data() const;
+    size_t bytes() const;
+
+    // The item at the given index
+    T get(size_t idx) const;
+
+    // Writes every item to out, which must have room for size() items
+    void decodeTo(T* out) const;
+
+    // Calls f(item) for every item in order, unpacking them in registers
+    // without writing them out first
+    template <typename F>
+    void forEach(F f) const;
+};
+
+#include "encoding.tpp"
@@ -0,0 +1,375 @@
+// lang::Cpp
+/**
+ * @file encoding.tpp
+ * @author Vincent Zhao, Michael Hebert
+ * @brief Template definitions for EncodedChunk
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+constexpr size_t WORD_BITS = 64;  // Bits per packed word
+
+// Number of bits needed to store values up to range
+inline unsigned bitWidth(uint64_t range) {
+    return range ? WORD_BITS - __builtin_clzll(range) : 0;
+}
+
+// Number of words holding count values of the given width, with a spare word
+inline size_t packedWords(size_t count, unsigned bits) {
+    return (count * bits + WORD_BITS - 1) / WORD_BITS + 1;
+}
+
+// Mask of the low bits of a word
+inline uint64_t lowBits(unsigned bits) {
+    return bits == WORD_BITS ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+}
+
+// Stores value, which must fit in bits, as the idx-th packed value
+inline void packBits(uint64_t* words, size_t idx, unsigned bits,
+                     uint64_t value) {
+    if (!bits) return;
+    size_t bit = idx * bits;
+    size_t word = bit / WORD_BITS;
+    unsigned offset = bit % WORD_BITS;
+
+    words[word] |= value << offset;
+    if (offset + bits > WORD_BITS) {
+        words[word + 1] |= value >> (WORD_BITS - offset);
+    }
+}
+
+// The idx-th packed value
+inline uint64_t unpackBits(const uint64_t* words, size_t idx, unsigned bits) {
+    if (!bits) return 0;
+    size_t bit = idx * bits;
+    size_t word = bit / WORD_BITS;
+    unsigned offset = bit % WORD_BITS;
+
+    uint64_t value = words[word] >> offset;
+    if (offset + bits > WORD_BITS) {
+        value |= words[word + 1] << (WORD_BITS - offset);
+    }
+    return value & lowBits(bits);
+}
+
+// Reads packed values in order, keeping the current word in a register
+class BitReader {
+   private:
+    const uint64_t* _word;  // word being read
+    uint64_t _current;      // its value
+    unsigned _offset = 0;   // bits of it already read
+    unsigned _bits;         // width of each value
+    uint64_t _mask;         // low _bits bits
+
+   public:
+    BitReader(const uint64_t* words, unsigned bits)
+        : _word(words), _current(*words), _bits(bits), _mask(lowBits(bits)) {}
+
+    // The next value, reading past the last one is undefined
+    uint64_t next() {
+        if (!_bits) return 0;
+
+        uint64_t value = _current >> _offset;
+        unsigned end = _offset + _bits;
+        if (end >= WORD_BITS) {
+            _current = *++_word;
+            if (end > WORD_BITS) value |= _current << (WORD_BITS - _offset);
+            end -= WORD_BITS;
+        }
+        _offset = end;
+
+        return value & _mask;
+    }
+};
+
+// Words of the header of FrameOfReference and Delta chunks
+constexpr size_t FOR_HEADER_WORDS = 2;
+constexpr size_t DELTA_HEADER_WORDS = 3;
+}  // namespace
+
+template <typename T>
+inline EncodedChunk<T>::EncodedChunk() {}
+
+// Sizes every encoding first and then only builds the smallest. Differences
+// are taken as int64_t, and Delta is ruled out if one overflows.
+template <typename T>
+inline EncodedChunk<T> EncodedChunk<T>::encode(const T* items, size_t size) {
+    static_assert(isEncodable<T>(), "Only signed integers can be encoded");
+
+    EncodedChunk<T> chunk;
+    chunk._size = size;
+
+    size_t best = size * sizeof(T);
+    if (size) {
+        size_t runs = 1;
+        T min = items[0];
+        T max = items[0];
+        int64_t minDelta = std::numeric_limits<int64_t>::max();
+        int64_t maxDelta = std::numeric_limits<int64_t>::min();
+        bool deltaFits = true;
+
+        for (size_t ii = 1; ii < size; ii++) {
+            runs += items[ii] != items[ii - 1];
+            min = std::min(min, items[ii]);
+            max = std::max(max, items[ii]);
+
+            int64_t delta;
+            deltaFits &= !__builtin_sub_overflow(
+                static_cast<int64_t>(items[ii]),
+                static_cast<int64_t>(items[ii - 1]), &delta);
+            minDelta = std::min(minDelta, delta);
+            maxDelta = std::max(maxDelta, delta);
+        }
+
+        unsigned forBits = bitWidth(static_cast<uint64_t>(max) -
+                                    static_cast<uint64_t>(min));
+        unsigned deltaBits = bitWidth(static_cast<uint64_t>(maxDelta) -
+                                      static_cast<uint64_t>(minDelta));
+        size_t checkpoints = (size - 1) / DELTA_CHECKPOINT + 1;
+
+        size_t runBytes = runs * (sizeof(T) + sizeof(uint32_t));
+        size_t forBytes =
+            (FOR_HEADER_WORDS + packedWords(size, forBits)) * sizeof(uint64_t);
+        size_t deltaBytes = (DELTA_HEADER_WORDS + checkpoints +
+                             packedWords(size - 1, deltaBits)) *
+                            sizeof(uint64_t);
+        if (size < 2 || !deltaFits) deltaBytes = SIZE_MAX;
+
+        if (forBytes < best) {
+            best = forBytes;
+            chunk._encoding = IntEncoding::FrameOfReference;
+        }
+        if (deltaBytes < best) {
+            best = deltaBytes;
+            chunk._encoding = IntEncoding::Delta;
+        }
+        if (runBytes < best) {
+            best = runBytes;
+            chunk._encoding = IntEncoding::RunLength;
+        }
+
+        chunk._length = best;
+        chunk._words.assign((best + sizeof(uint64_t) - 1) / sizeof(uint64_t),
+                            0);
+        uint64_t* words = chunk._words.data();
+
+        switch (chunk._encoding) {
+            case IntEncoding::RunLength: {
+                T* values = reinterpret_cast<T*>(words);
+                uint32_t* ends = reinterpret_cast<uint32_t*>(values + runs);
+                size_t run = 0;
+                for (size_t ii = 1; ii <= size; ii++) {
+                    if (ii == size || items[ii] != items[ii - 1]) {
+                        values[run] = items[ii - 1];
+                        ends[run++] = ii;
+                    }
+                }
+                break;
+            }
+            case IntEncoding::FrameOfReference: {
+                words[0] = static_cast<uint64_t>(static_cast<int64_t>(min));
+                words[1] = forBits;
+                uint64_t* packed = words + FOR_HEADER_WORDS;
+                for (size_t ii = 0; ii < size; ii++) {
+                    packBits(packed, ii, forBits,
+                             static_cast<uint64_t>(items[ii]) -
+                                 static_cast<uint64_t>(min));
+                }
+                break;
+            }
+            case IntEncoding::Delta: {
+                words[0] =
+                    static_cast<uint64_t>(static_cast<int64_t>(items[0]));
+                words[1] = static_cast<uint64_t>(minDelta);
+                words[2] = deltaBits;
+                uint64_t* marks = words + DELTA_HEADER_WORDS;
+                uint64_t* packed = marks + checkpoints;
+                for (size_t ii = 0; ii < size; ii++) {
+                    if (ii % DELTA_CHECKPOINT == 0) {
+                        marks[ii / DELTA_CHECKPOINT] = static_cast<uint64_t>(
+                            static_cast<int64_t>(items[ii]));
+                    }
+                    if (ii) {
+                        uint64_t delta = static_cast<uint64_t>(items[ii]) -
+                                         static_cast<uint64_t>(items[ii - 1]);
+                        packBits(packed, ii - 1, deltaBits,
+                                 delta - static_cast<uint64_t>(minDelta));
+                    }
+                }
+                break;
+            }
+            case IntEncoding::Plain:
+                memcpy(words, items, best);
+                break;
+        }
+    }
+
+    return chunk;
+}
+
+// Checks the length implied by the headers before copying, and that there is
+// at least one run and run ends increase up to size
+template <typename T>
+inline bool EncodedChunk<T>::decode(IntEncoding encoding, size_t size,
+                                    const uint8_t* bytes, size_t length,
+                                    EncodedChunk& chunk) {
+    const size_t wordBytes = sizeof(uint64_t);
+    uint64_t header[DELTA_HEADER_WORDS] = {};
+    size_t expected = 0;
+
+    switch (encoding) {
+        case IntEncoding::Plain:
+            expected = size * sizeof(T);
+            break;
+        case IntEncoding::RunLength:
+            if (!size || !length || length % (sizeof(T) + sizeof(uint32_t))) {
+                return false;
+            }
+            expected = length;
+            break;
+        case IntEncoding::FrameOfReference:
+            if (!size || length < FOR_HEADER_WORDS * wordBytes) return false;
+            memcpy(header, bytes, FOR_HEADER_WORDS * wordBytes);
+            if (header[1] > WORD_BITS) return false;
+            expected = (FOR_HEADER_WORDS + packedWords(size, header[1])) *
+                       wordBytes;
+            break;
+        case IntEncoding::Delta:
+            if (size < 2 || length < DELTA_HEADER_WORDS * wordBytes) {
+                return false;
+            }
+            memcpy(header, bytes, DELTA_HEADER_WORDS * wordBytes);
+            if (header[2] > WORD_BITS) return false;
+            expected = (DELTA_HEADER_WORDS + (size - 1) / DELTA_CHECKPOINT + 1 +
+                        packedWords(size - 1, header[2])) *
+                       wordBytes;
+            break;
+        default:
+            return false;
+    }
+    if (length != expected) return false;
+
+    chunk._encoding = encoding;
+    chunk._size = size;
+    chunk._length = length;
+    chunk._words.assign((length + wordBytes - 1) / wordBytes, 0);
+    if (length) memcpy(chunk._words.data(), bytes, length);
+
+    if (encoding == IntEncoding::RunLength) {
+        size_t runs = length / (sizeof(T) + sizeof(uint32_t));
+        const uint32_t* ends = reinterpret_cast<const uint32_t*>(
+            reinterpret_cast<const T*>(chunk._words.data()) + runs);
+        for (size_t ii = 0; ii < runs; ii++) {
+            if (ends[ii] <= (ii ? ends[ii - 1] : 0)) return false;
+        }
+        if (ends[runs - 1] != size) return false;
+    }
+
+    return true;
+}
+
+template <typename T>
+inline IntEncoding EncodedChunk<T>::encoding() const {
+    return _encoding;
+}
+
+template <typename T>
+inline size_t EncodedChunk<T>::size() const {
+    return _size;
+}
+
+template <typename T>
+inline const uint8_t* EncodedChunk<T>::data() const {
+    return reinterpret_cast<const uint8_t*>(_words.data());
+}
+
+template <typename T>
+inline size_t EncodedChunk<T>::bytes() const {
+    return _length;
+}
+
+template <typename T>
+inline T EncodedChunk<T>::get(size_t idx) const {
+    const uint64_t* words = _words.data();
+
+    switch (_encoding) {
+        case IntEncoding::RunLength: {
+            size_t runs = _length / (sizeof(T) + sizeof(uint32_t));
+            const T* values = reinterpret_cast<const T*>(words);
+            const uint32_t* ends =
+                reinterpret_cast<const uint32_t*>(values + runs);
+            return values[std::upper_bound(ends, ends + runs, idx) - ends];
+        }
+        case IntEncoding::FrameOfReference:
+            return static_cast<T>(
+                words[0] + unpackBits(words + FOR_HEADER_WORDS, idx, words[1]));
+        case IntEncoding::Delta: {
+            size_t mark = idx / DELTA_CHECKPOINT;
+            const uint64_t* packed =
+                words + DELTA_HEADER_WORDS + (_size - 1) / DELTA_CHECKPOINT + 1;
+            uint64_t value = words[DELTA_HEADER_WORDS + mark];
+            for (size_t ii = mark * DELTA_CHECKPOINT; ii < idx; ii++) {
+                value += words[1] + unpackBits(packed, ii, words[2]);
+            }
+            return static_cast<T>(value);
+        }
+        default:
+            return reinterpret_cast<const T*>(words)[idx];
+    }
+}
+
+template <typename T>
+inline void EncodedChunk<T>::decodeTo(T* out) const {
+    forEach([&out](T item) { *out++ = item; });
+}
+
+// Values are rebuilt in uint64_t, wrapping around like they did when they
+// were encoded
+template <typename T>
+template <typename F>
+inline void EncodedChunk<T>::forEach(F f) const {
+    const uint64_t* words = _words.data();
+
+    switch (_encoding) {
+        case IntEncoding::RunLength: {
+            size_t runs = _length / (sizeof(T) + sizeof(uint32_t));
+            const T* values = reinterpret_cast<const T*>(words);
+            const uint32_t* ends =
+                reinterpret_cast<const uint32_t*>(values + runs);
+            size_t ii = 0;
+            for (size_t run = 0; run < runs; run++) {
+                for (; ii < ends[run]; ii++) f(values[run]);
+            }
+            break;
+        }
+        case IntEncoding::FrameOfReference: {
+            uint64_t base = words[0];
+            BitReader reader(words + FOR_HEADER_WORDS, words[1]);
+            for (size_t ii = 0; ii < _size; ii++) {
+                f(static_cast<T>(base + reader.next()));
+            }
+            break;
+        }
+        case IntEncoding::Delta: {
+            uint64_t minDelta = words[1];
+            BitReader reader(
+                words + DELTA_HEADER_WORDS + (_size - 1) / DELTA_CHECKPOINT + 1,
+                words[2]);
+            uint64_t value = words[0];
+            f(static_cast<T>(value));
+            for (size_t ii = 1; ii < _size; ii++) {
+                value += minDelta + reader.next();
+                f(static_cast<T>(value));
+            }
+            break;
+        }
+        default: {
+            const T* items = reinterpret_cast<const T*>(words);
+            for (size_t ii = 0; ii < _size; ii++) f(items[ii]);
+        }
+    }
+}
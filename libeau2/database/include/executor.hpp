@@ -0,0 +1,121 @@
+// lang::Cpp
+/**
+ * @file executor.hpp
+ * @author Vincent Zhao, Michael Hebert
+ * @brief A persistent, work-stealing pool of worker threads shared by the
+ * whole process, and task groups that can be waited on.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Task = std::function<void()>;
+
+/**
+ * @brief Runs tasks on a fixed set of worker threads that live as long as the
+ * Executor. Each worker has its own deque of tasks: it pushes and pops tasks
+ * at the back, and when it runs out it steals from the front of the other
+ * workers' deques. Tasks submitted from outside the pool are spread round
+ * robin across the workers.
+ */
+class Executor {
+   private:
+    // A worker's own queue of tasks
+    struct Queue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> _queues;  // one queue per worker
+    std::vector<std::thread> _threads;            // the workers
+    std::atomic<size_t> _queued{0};  // tasks waiting in any of the queues
+    std::atomic<size_t> _nextQueue{0};  // round robin for outside submits
+    std::atomic<bool> _done{false};     // set when shutting down
+    std::mutex _sleepLock;              // guards idle workers going to sleep
+    std::condition_variable _wake;      // wakes idle workers
+
+    // Main loop of the worker at the given index
+    void _work(size_t idx);
+
+    // Pops a task from the given worker's queue, or steals one from another
+    // worker, and runs it. Returns whether a task was run.
+    bool _runOne(size_t idx);
+
+   public:
+    // Value returned by workerIdx() on threads outside the pool
+    static constexpr size_t NOT_A_WORKER = static_cast<size_t>(-1);
+
+    // Starts the given number of workers, 0 uses one per hardware thread
+    explicit Executor(size_t numThreads = 0);
+
+    // Executors own their threads and cannot be copied
+    Executor(const Executor& other) = delete;
+    void operator=(const Executor& other) = delete;
+
+    // Runs the tasks still queued, then stops and joins the workers
+    ~Executor();
+
+    // The Executor shared by the whole process, started on first use
+    static Executor& global();
+
+    // Number of worker threads
+    size_t size() const;
+
+    // Index of the calling thread in this pool, or NOT_A_WORKER
+    size_t workerIdx() const;
+
+    // Queues a task to be run by one of the workers
+    void submit(Task task);
+
+    // Runs one queued task on the calling worker thread if there is one.
+    // Returns false without doing anything when called outside the pool.
+    bool tryRunOne();
+
+    // Runs queued tasks on the calling worker thread until done() holds,
+    // sleeping while there are none. Whoever makes done() hold must call
+    // notifyHelpers() afterwards.
+    void helpUntil(const std::function<bool()>& done);
+
+    // Wakes the workers sleeping in helpUntil() to check on done()
+    void notifyHelpers();
+};
+
+/**
+ * @brief A set of tasks run on an Executor that can be waited on together.
+ * Waiting from a worker thread runs other queued tasks in the meantime, so
+ * tasks can safely start and wait on groups of their own. The first
+ * exception thrown by a task is rethrown by wait().
+ */
+class TaskGroup {
+   private:
+    Executor& _exec;                // runs the tasks
+    std::atomic<size_t> _pending;   // tasks not finished yet
+    std::mutex _lock;               // guards _error and the final wakeup
+    std::condition_variable _idle;  // signalled when _pending reaches 0
+    std::exception_ptr _error;      // first exception thrown by a task
+
+   public:
+    explicit TaskGroup(Executor& exec = Executor::global());
+
+    // Groups cannot be copied, tasks refer to them
+    TaskGroup(const TaskGroup& other) = delete;
+    void operator=(const TaskGroup& other) = delete;
+
+    // Waits for the remaining tasks, dropping any exception
+    ~TaskGroup();
+
+    // Runs the task as part of the group
+    void run(Task task);
+
+    // Blocks until every task of the group is done
+    void wait();
+};
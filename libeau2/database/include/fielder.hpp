@@ -6,6 +6,8 @@
  */
 #pragma once
 
+#include <string_view>
+
 #include "commondefs.hpp"
 
 /*****************************************************************************
@@ -22,7 +24,10 @@ class Fielder {
     virtual void accept(bool b) = 0;
     virtual void accept(double d) = 0;
     virtual void accept(int i) = 0;
-    virtual void accept(ExtString s) = 0;
+    virtual void accept(std::string_view s) = 0;
+
+    /** Called instead of accept() for fields that are missing. */
+    virtual void acceptMissing() {}
 
     /** Called when all fields have been seen. */
     virtual void done() {}
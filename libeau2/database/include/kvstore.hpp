@@ -8,9 +8,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
@@ -38,7 +40,9 @@ class KVStore {
     DFMap _store;                   // the store itself
     KVNet& _kvNet;  // network interface for communicating with other KVStores
     std::thread _listener;  // listener thread that handles network messages
-    size_t _idx;            // node index
+    std::atomic<size_t> _idx = 0;  // node index, 0 until registered
+    std::mutex _idxMutex;          // lock for waiting on registration
+    std::condition_variable _registered;  // notified once _idx is set
     std::condition_variable_any
         _cv;  // conditional variable, used for waiting for new data to be
               // submitted to the store
@@ -47,7 +51,7 @@ class KVStore {
     std::mutex
         _pendingMutex;  // ensures single read/write access to pending messages
 
-    // Listening logic for handling network communications
+    // Handles network messages as they arrive
     void _listen(const char* address, const char* port);
 
     // Processes a reply and adds/redirects data as needed
@@ -76,7 +80,7 @@ class KVStore {
 
     // Adds a DataFrame to the store at the key provided, assuming it does not
     // already exist
-    void insert(const Key& key, DFPtr value);
+    void insert(const Key& key, const DFPtr& value);
 
     // Waits for the DataFrame at the given key to become available locally,
     // otherwise nullptr
@@ -86,6 +90,12 @@ class KVStore {
     // to the network
     void fetch(const Key& key, bool wait);
 
-    // Pushes a DataFrame to a remote KVStore
-    void push(const Key& key, DFPtr value);
+    // Pushes a DataFrame to a remote KVStore. done, if given, is called once
+    // the DataFrame is stored locally or the network is done with it, unless
+    // push throws.
+    void push(const Key& key, const DFPtr& value,
+              std::function<void()> done = nullptr);
+
+    // The index of this node, waiting for it to register
+    size_t idx();
 };
\ No newline at end of file
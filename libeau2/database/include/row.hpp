@@ -9,6 +9,7 @@
 #pragma once
 
 #include <cstddef>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -31,7 +32,9 @@ class Row {
     size_t _idx;
 
     // TODO this is pretty ugly
-    std::vector<std::variant<int, double, bool, ExtString>> _data;
+    std::vector<std::variant<int, double, bool, std::string_view, ExtString>>
+        _data;
+    std::vector<bool> _missing;  // which fields are missing
 
    public:
     /** Build a row following a schema. */
@@ -48,6 +51,17 @@ class Row {
     // String is external
     void set(size_t col, ExtString val);
 
+    // The string is not copied, it must outlive its use through the row, as
+    // the strings of a DataFrame filling the row do
+    void set(size_t col, std::string_view val);
+
+    /** Marks the given field as missing, setting a value makes it present
+     * again. */
+    void setMissing(size_t col);
+
+    /** Whether the given field is missing. */
+    bool isMissing(size_t col);
+
     /** Set/get the index of this row (ie. its position in the dataframe. This
      * is only used for informational purposes, unused otherwise */
     void setIdx(size_t idx);
@@ -59,7 +73,7 @@ class Row {
     int getInt(size_t col);
     bool getBool(size_t col);
     double getDouble(size_t col);
-    ExtString getString(size_t col);
+    std::string_view getString(size_t col);
 
     /** Number of fields in the row. */
     size_t width();
@@ -69,7 +83,8 @@ class Row {
     char col_type(size_t idx);
 
     /** Given a Fielder, visit every field of this row. The first argument is
-     * index of the row in the dataframe.
+     * index of the row in the dataframe. Missing fields are passed to
+     * acceptMissing().
      * Calling this method before the row's fields have been set is undefined.
      */
     void visit(size_t idx, Fielder& f);
@@ -0,0 +1,89 @@
+/**
+ * @file rowbatch.hpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bitmap.hpp"
+#include "row.hpp"
+#include "span.hpp"
+
+class DataFrame;
+class Schema;
+
+/*************************************************************************
+ * RowBatch::
+ *
+ * A window of consecutive rows of a DataFrame handed to a Rower in one call.
+ * Each column of the window can be read as a contiguous, typed Block, which
+ * lets Rowers process thousands of rows with tight loops instead of one Row
+ * at a time. Windows never straddle a chunk boundary of any column. Filters
+ * read the per-row selection flags after the Rower is done with the batch.
+ */
+class RowBatch {
+   private:
+    DataFrame& _df;                  // frame the rows belong to
+    size_t _start;                   // index of the first row in the batch
+    size_t _size;                    // number of rows in the batch
+    std::vector<uint8_t> _selected;  // per-row results, 1 keeps the row
+    Row _row;                        // reused for row at a time access
+
+   public:
+    /** Creates a batch over rows [start, start + size) of the DataFrame. The
+     * window must not cross a multiple of maxSize(). */
+    RowBatch(DataFrame& df, size_t start, size_t size);
+
+    /** Index of the first row of the batch in the DataFrame. */
+    size_t start() const;
+
+    /** Number of rows in the batch. */
+    size_t size() const;
+
+    /** The rows of the batch in the given column as a contiguous Block.
+     * Throws if the column is not of the requested type. */
+    template <typename T>
+    Block<T> column(size_t col);
+
+    /** Dictionary codes of the rows of the batch in the given string column,
+     * so that filters can compare codes instead of strings. Throws if the
+     * column is not a dictionary encoded string column. */
+    Block<uint32_t> codes(size_t col);
+
+    /** Values of the rows of the batch in the given bool column, packed 64
+     * to a word. Throws if the column is not a bool column. */
+    Block<uint64_t> bits(size_t col);
+
+    /** Per-row selection flags, one byte per row of the batch, which can be
+     * written directly by branch-free loops. All rows start deselected. */
+    uint8_t* selected();
+
+    /** Marks whether the row at the given offset in the batch is kept. */
+    void select(size_t idx, bool keep);
+
+    /** Whether the row at the given offset in the batch is kept. */
+    bool isSelected(size_t idx) const;
+
+    /** Number of rows kept in the batch. */
+    size_t selectedCount() const;
+
+    /** The selection packed into a Bitmap, one bit per row of the batch. */
+    Bitmap selection() const;
+
+    /** Fills and returns a Row holding the row at the given offset in the
+     * batch. The Row is reused by the next call. */
+    Row& row(size_t idx);
+
+    /** Largest number of rows in a batch for a DataFrame with the given
+     * schema, the smallest chunk size across its columns. */
+    static size_t maxSize(const Schema& schema);
+};
+
+#include "rowbatch.tpp"
@@ -0,0 +1,18 @@
+/**
+ * @file rowbatch.tpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#pragma once
+
+#include "dataframe.hpp"
+
+/** The rows of the batch in the given column as a contiguous Block.
+ * Throws if the column is not of the requested type. */
+template <typename T>
+inline Block<T> RowBatch::column(size_t col) {
+    return _df.column<T>(col).slice(_start, _size);
+}
@@ -11,6 +11,8 @@
 #include <memory>
 #include "row.hpp"
 
+class RowBatch;
+
 /*******************************************************************************
  *  Rower::
  *  An interface for iterating through each row of a data frame. The intent
@@ -27,6 +29,13 @@ class Rower {
         should be kept. */
     virtual bool accept(Row& r) = 0;
 
+    /** This method is called once per batch of consecutive rows, and is how
+        the data frame actually drives a Rower. Overriding it lets a Rower
+        scan whole typed column slices at once, and record which rows a
+        filter keeps in the batch's selection. The default calls accept()
+        on each row of the batch. */
+    virtual void acceptBatch(RowBatch& batch);
+
     /** Once traversal of the data frame is complete the rowers that were
         split off will be joined.  There will be one join per split. The
         original object will be the last to be called join on. The join
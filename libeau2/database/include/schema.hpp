@@ -31,9 +31,10 @@ class Schema {
     std::vector<ExtString> _rowNames;  // names of rows
     std::vector<ExtString> _colNames;  // names of columns
     std::vector<char> _colTypes;       // types of columns
+    std::vector<bool> _nullable;       // may the column have missing values
     bool _local;     // does this Schema correspond to local data?
-    size_t _length;  // if Schema is remote, is the total length of the
-                     // distributed DataFrame
+    size_t _length = 0;  // if Schema is remote, is the total length of the
+                         // distributed DataFrame
 
    public:
     /** Copying constructor */
@@ -57,12 +58,15 @@ class Schema {
     template <typename T>
     bool addCol(const Column<T>& col, ExtString name = nullptr);
 
-    bool addCol(char type, ExtString name = nullptr);
+    bool addCol(char type, ExtString name = nullptr, bool nullable = false);
 
     /** Add a row with a name (possibly nullptr), name is external.  Names
      * are expectd to be unique, duplicates result in undefined behavior. */
     void addRow(ExtString name);
 
+    /** Removes every row, keeping the columns. */
+    void clearRows();
+
     /** Return name of row at idx; nullptr indicates no name. An idx >=
      * width is undefined. */
     std::string rowName(size_t idx) const;
@@ -76,6 +80,13 @@ class Schema {
 
     Serial::Type colSerialType(size_t idx) const;
 
+    /** Whether the column at idx may have missing values. An idx >= width is
+     * undefined. */
+    bool isNullable(size_t idx) const;
+
+    /** Marks whether the column at idx may have missing values. */
+    void setNullable(size_t idx, bool nullable);
+
     /** Given a column name return its index, or -1. */
     int colIdx(const char* name) const;
 
@@ -88,6 +99,9 @@ class Schema {
     /** The number of rows */
     size_t length() const;
 
+    /** Sets the total number of rows of a remote Schema. */
+    void setLength(size_t length);
+
     template <typename T>
     static char colToType(const Column<T>& col);
 
@@ -25,7 +25,7 @@ inline bool Schema::addCol(const Column<T>& col, ExtString name) {
         return false;
     }
 
-    return addCol(colType, name);
+    return addCol(colType, name, col.nullCount() > 0);
 }
 
 // specializations
@@ -0,0 +1,52 @@
+// lang::Cpp
+/**
+ * @file slab.hpp
+ * @author Vincent Zhao, Michael Hebert
+ * @brief A simple slab allocator that hands out fixed-size, aligned blocks of
+ * memory carved out of larger regions.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Allocates fixed-size blocks from a small number of large, aligned
+ * regions. Blocks are never returned individually, all memory is released
+ * when the Slab is destroyed. Regions grow geometrically so that small
+ * Columns don't reserve more memory than they need.
+ */
+class Slab {
+   private:
+    size_t _blockSize;             // size of each block handed out
+    size_t _alignment;             // alignment of each block
+    std::vector<void*> _regions;   // regions allocated so far
+    uint8_t* _next = nullptr;      // next free block in current region
+    size_t _blocksLeft = 0;        // free blocks left in current region
+    size_t _nextRegionBlocks = 1;  // number of blocks in the next region
+
+    // Allocates a new region with room for _nextRegionBlocks blocks
+    void _grow();
+
+   public:
+    // Creates a Slab handing out blocks of the given size and alignment, the
+    // block size must be a multiple of the alignment
+    Slab(size_t blockSize, size_t alignment);
+
+    // Slabs own their memory and cannot be copied
+    Slab(const Slab& other) = delete;
+    void operator=(const Slab& other) = delete;
+
+    // Frees all regions
+    ~Slab();
+
+    // Returns a new uninitialized block of blockSize() bytes
+    void* allocate();
+
+    // Size of each block in bytes
+    size_t blockSize() const;
+
+    // Frees every region, invalidating all blocks handed out so far
+    void clear();
+};
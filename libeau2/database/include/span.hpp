@@ -0,0 +1,90 @@
+// lang::Cpp
+/**
+ * @file span.hpp
+ * @author Vincent Zhao, Michael Hebert
+ * @brief Typed, read-only views over the contiguous blocks of a Column.
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+template <typename T>
+class Column;
+
+/**
+ * @brief A contiguous run of items in a Column, usually one Chunk's worth.
+ * Blocks are plain pointer ranges so that loops over them can be vectorized by
+ * the compiler. A Block is only valid as long as its Column is not modified.
+ * Blocks of encoded chunks hold their decoded items themselves.
+ */
+template <typename T>
+class Block {
+   private:
+    const T* _data;  // first item of the block
+    size_t _size;    // number of items in the block
+    std::shared_ptr<const T[]> _owned;  // decoded items, if the Block has any
+
+   public:
+    Block(const T* data, size_t size);
+
+    // A Block of items decoded for it, kept alive by the Block and its copies
+    Block(std::shared_ptr<const T[]> owned, const T* data, size_t size);
+
+    const T* begin() const;
+    const T* end() const;
+    const T* data() const;
+    size_t size() const;
+
+    const T& operator[](size_t idx) const;
+};
+
+/**
+ * @brief A typed view of an entire Column as a sequence of Blocks.
+ *
+ * for (const Block<double>& block : df.column<double>(0))
+ *     for (double val : block) sum += val;
+ */
+template <typename T>
+class ColumnSpan {
+   private:
+    std::shared_ptr<Column<T>> _col;  // keeps the Column alive
+
+   public:
+    // Iterates over the Blocks of a ColumnSpan
+    class Iterator {
+       private:
+        const Column<T>* _col;
+        size_t _chunkIdx;
+
+       public:
+        Iterator(const Column<T>* col, size_t chunkIdx);
+
+        Block<T> operator*() const;
+        Iterator& operator++();
+        bool operator!=(const Iterator& other) const;
+    };
+
+    explicit ColumnSpan(std::shared_ptr<Column<T>> col);
+
+    Iterator begin() const;
+    Iterator end() const;
+
+    // number of Blocks in the span
+    size_t blocks() const;
+
+    // the Block at the given index
+    Block<T> block(size_t idx) const;
+
+    // the items [start, start + len) as a Block, must lie within one chunk
+    Block<T> slice(size_t start, size_t len) const;
+
+    // total number of items in the span
+    size_t size() const;
+
+    // the Column being viewed
+    const Column<T>& column() const;
+};
+
+#include "span.tpp"
@@ -0,0 +1,99 @@
+// lang::Cpp
+/**
+ * @file span.tpp
+ * @author Vincent Zhao, Michael Hebert
+ * @brief Template definitions for Block and ColumnSpan.
+ */
+#pragma once
+
+template <typename T>
+inline Block<T>::Block(const T* data, size_t size) : _data(data), _size(size) {}
+
+template <typename T>
+inline Block<T>::Block(std::shared_ptr<const T[]> owned, const T* data,
+                       size_t size)
+    : _data(data), _size(size), _owned(std::move(owned)) {}
+
+template <typename T>
+inline const T* Block<T>::begin() const {
+    return _data;
+}
+
+template <typename T>
+inline const T* Block<T>::end() const {
+    return _data + _size;
+}
+
+template <typename T>
+inline const T* Block<T>::data() const {
+    return _data;
+}
+
+template <typename T>
+inline size_t Block<T>::size() const {
+    return _size;
+}
+
+template <typename T>
+inline const T& Block<T>::operator[](size_t idx) const {
+    return _data[idx];
+}
+
+template <typename T>
+inline ColumnSpan<T>::Iterator::Iterator(const Column<T>* col, size_t chunkIdx)
+    : _col(col), _chunkIdx(chunkIdx) {}
+
+template <typename T>
+inline Block<T> ColumnSpan<T>::Iterator::operator*() const {
+    return _col->block(_chunkIdx);
+}
+
+template <typename T>
+inline typename ColumnSpan<T>::Iterator& ColumnSpan<T>::Iterator::operator++() {
+    _chunkIdx++;
+    return *this;
+}
+
+template <typename T>
+inline bool ColumnSpan<T>::Iterator::operator!=(const Iterator& other) const {
+    return _chunkIdx != other._chunkIdx;
+}
+
+template <typename T>
+inline ColumnSpan<T>::ColumnSpan(std::shared_ptr<Column<T>> col)
+    : _col(std::move(col)) {}
+
+template <typename T>
+inline typename ColumnSpan<T>::Iterator ColumnSpan<T>::begin() const {
+    return Iterator(_col.get(), 0);
+}
+
+template <typename T>
+inline typename ColumnSpan<T>::Iterator ColumnSpan<T>::end() const {
+    return Iterator(_col.get(), _col->blocks());
+}
+
+template <typename T>
+inline size_t ColumnSpan<T>::blocks() const {
+    return _col->blocks();
+}
+
+template <typename T>
+inline Block<T> ColumnSpan<T>::block(size_t idx) const {
+    return _col->block(idx);
+}
+
+template <typename T>
+inline Block<T> ColumnSpan<T>::slice(size_t start, size_t len) const {
+    return _col->slice(start, len);
+}
+
+template <typename T>
+inline size_t ColumnSpan<T>::size() const {
+    return _col->size();
+}
+
+template <typename T>
+inline const Column<T>& ColumnSpan<T>::column() const {
+    return *_col;
+}
@@ -0,0 +1,135 @@
+// lang::Cpp
+/**
+ * @file stringcolumn.hpp
+ * @author Vincent Zhao, Michael Hebert
+ * @brief Column specialization storing strings in one contiguous arena.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "commondefs.hpp"
+#include "stringdict.hpp"
+
+/**
+ * Column<ExtString>
+ *
+ * Stores its strings back to back, NUL terminated, in a single byte arena,
+ * with one offset into the arena per item. This avoids the control block,
+ * string object and heap buffer an ExtString costs per item. When interning
+ * is enabled, repeated values share a single copy in the arena.
+ *
+ * As long as items are only appended and not interned, the arena holds
+ * exactly the column's strings in order, which is also their serialized form.
+ *
+ * A dictionary encoded column instead stores a code per item from a
+ * StringDict that can be shared between columns. Filters and group-bys can
+ * then compare codes, and the column serializes as the dictionary plus 4
+ * bytes per item.
+ * */
+template <>
+class Column<ExtString> : public ColumnInterface {
+   private:
+    // Hashes and compares interned strings by their offset in the arena
+    struct ArenaHash {
+        const std::vector<char>* arena;
+        size_t operator()(uint64_t offset) const;
+    };
+    struct ArenaEqual {
+        const std::vector<char>* arena;
+        bool operator()(uint64_t a, uint64_t b) const;
+    };
+    using InternSet = std::unordered_set<uint64_t, ArenaHash, ArenaEqual>;
+
+    std::vector<char> _arena;  // NUL terminated strings, back to back
+    Column<uint64_t> _offsets;  // start of each item in the arena
+    std::unique_ptr<InternSet> _interned;  // set when interning is enabled
+    bool _dense = true;  // arena holds exactly the items in order
+    std::shared_ptr<StringDict> _dict;  // set when dictionary encoded
+    Column<uint32_t> _codes;            // dictionary code of each item
+
+    // Appends the string to the arena, or finds its interned copy, and
+    // returns its offset
+    uint64_t _store(std::string_view val);
+
+   public:
+    // construct a column, interning repeated values if requested
+    explicit Column(bool intern = false);
+
+    // Columns cannot be moved from their intial instantiation
+    Column(Column<ExtString>&& other) = delete;
+
+    // Columns cannot be copied
+    Column(const Column<ExtString>& other) = delete;
+
+    // construct a dictionary encoded column using the given dictionary
+    explicit Column(std::shared_ptr<StringDict> dict);
+
+    // Creates a column with the provided elements
+    Column(std::initializer_list<ExtString> ll);
+
+    // Creates a column of size items from an arena of arenaBytes bytes and
+    // offsets laid out as Column<uint64_t> chunks. The offsets are used in
+    // place, backing keeps their memory alive, the arena is copied.
+    Column(std::shared_ptr<void> backing, const char* arena,
+           size_t arenaBytes, void* offsets, size_t size);
+
+    // View of the value at the given index in the arena or dictionary,
+    // valid until the column is modified
+    std::string_view get(size_t idx) const;
+
+    // Set value at idx. An out of bound idx is undefined
+    void set(size_t idx, ExtString val);
+    void set(size_t idx, std::string_view val);
+
+    // Adds a value to the end of the column, nullptr is stored as ""
+    void push_back(ExtString val);
+    void push_back(std::string_view val);
+
+    // Adds a missing item to the end of the column
+    void pushMissing() override;
+
+    // Adds NUL terminated strings packed back to back, as produced by
+    // serialize(). Data after the last NUL is ignored.
+    void pushPacked(const char* strings, size_t size);
+
+    // Whether repeated values are interned
+    bool interned() const;
+
+    // The dictionary of an encoded column, nullptr if not encoded
+    const std::shared_ptr<StringDict>& dict() const;
+
+    // Dictionary code of the item at the given index, encoded columns only
+    uint32_t code(size_t idx) const;
+
+    // Codes of every item, encoded columns only
+    const Column<uint32_t>& codes() const;
+
+    // Adds an item by its code in dict(), encoded columns only
+    void pushCode(uint32_t code);
+
+    // Number of bytes used by the arena
+    size_t arenaBytes() const;
+
+    /** Returns the number of elements in the column. */
+    size_t size() const override;
+
+    /** Returns the column as a string "a, b, c, d" */
+    std::string str() const override;
+
+    //! Serializes the given Column
+    void serialize(Serializer& ss) const override;
+
+    // Serializes the Column, leaving out its dictionary if it is among those
+    // already sent with the same DataFrame, and adding it otherwise
+    void serialize(Serializer& ss,
+                   std::vector<const StringDict*>& sentDicts) const;
+
+    //! Checks if the Column contains serializable types
+    bool canSerialize() const override;
+};
@@ -0,0 +1,49 @@
+// lang::Cpp
+/**
+ * @file stringdict.hpp
+ * @author Vincent Zhao, Michael Hebert
+ * @brief A dictionary assigning small integer codes to distinct strings.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief Maps each distinct string to a dense code, in order of first
+ * appearance. Dictionary encoded string Columns store codes and share a
+ * StringDict, so equal strings compare as equal codes. Looking up and
+ * reading codes is safe from several threads, adding strings is not.
+ */
+class StringDict {
+   private:
+    std::deque<std::string> _strings;  // strings by code, never move
+    std::unordered_map<std::string_view, uint32_t>
+        _codes;  // code of each string, views into _strings
+
+   public:
+    // Returned by find() for strings not in the dictionary
+    static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+    StringDict();
+
+    // Columns refer to their dictionary, it cannot be copied
+    StringDict(const StringDict& other) = delete;
+    void operator=(const StringDict& other) = delete;
+
+    // Returns the code of the string, adding it if it is new
+    uint32_t add(std::string_view str);
+
+    // Returns the code of the string, or NOT_FOUND
+    uint32_t find(std::string_view str) const;
+
+    // The string with the given code. An unknown code is undefined.
+    std::string_view str(uint32_t code) const;
+
+    // Number of distinct strings
+    size_t size() const;
+};
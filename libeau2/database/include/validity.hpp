@@ -0,0 +1,70 @@
+// lang::Cpp
+/**
+ * @file validity.hpp
+ * @author Vincent Zhao, Michael Hebert
+ * @brief Tracks which items of a Column are missing.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "bitmap.hpp"
+
+/**
+ * @brief A validity bitmap with a bit set for every present item. The bitmap
+ * is only allocated once an item goes missing, so columns without missing
+ * items pay nothing but a pointer check. The number of missing items in
+ * each chunk of CHUNK_ITEMS items is also kept, letting scans skip checking
+ * the bitmap for chunks without missing items.
+ */
+class Validity {
+   private:
+    std::unique_ptr<Bitmap> _present;  // nullptr while nothing is missing
+    std::vector<uint32_t> _chunkNulls;  // missing items per chunk
+    size_t _nulls = 0;                  // missing items in total
+    size_t _size = 0;                   // number of items tracked
+
+    // Recomputes the missing item counts from the bitmap
+    void _recount();
+
+    // Records a change in the number of missing items around idx
+    void _countNull(size_t idx, int delta);
+
+   public:
+    // Number of items covered by each missing item count
+    static constexpr size_t CHUNK_ITEMS = 8192;
+
+    Validity();
+
+    // Validity is owned by its Column
+    Validity(const Validity& other) = delete;
+    void operator=(const Validity& other) = delete;
+
+    // Whether the item at the given index is missing
+    bool isMissing(size_t idx) const;
+
+    // Adds an item to the end
+    void push_back(bool present);
+
+    // Marks the item at the given index as present or missing
+    void set(size_t idx, bool present);
+
+    // Grows or shrinks to size items, new items are present
+    void resize(size_t size);
+
+    // Number of missing items
+    size_t nullCount() const;
+
+    // Whether any item in [start, start + len) may be missing, only looks
+    // at the per-chunk counts
+    bool anyMissing(size_t start, size_t len) const;
+
+    // The validity bitmap, nullptr if no item is missing
+    const Bitmap* present() const;
+
+    // Replaces the validity with the given bitmap of present items
+    void assign(Bitmap present);
+};
@@ -0,0 +1,99 @@
+/**
+ * @file bitmap.cpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#include "bitmap.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+// Number of words needed for the given number of bits
+size_t wordsFor(size_t bits) {
+    return (bits + Bitmap::WORD_BITS - 1) / Bitmap::WORD_BITS;
+}
+}  // namespace
+
+Bitmap::Bitmap() : _size(0) {}
+
+Bitmap::Bitmap(size_t size, bool value) : _size(0) { resize(size, value); }
+
+// Words are stored little endian, so their bytes are in bit order
+Bitmap::Bitmap(const uint8_t* bytes, size_t size) : Bitmap(size) {
+    memcpy(_words.data(), bytes, (size + 7) / 8);
+    resize(size);
+}
+
+bool Bitmap::get(size_t idx) const {
+    return (_words[idx / WORD_BITS] >> (idx % WORD_BITS)) & 1;
+}
+
+void Bitmap::set(size_t idx, bool value) {
+    uint64_t mask = uint64_t(1) << (idx % WORD_BITS);
+    uint64_t& word = _words[idx / WORD_BITS];
+    word = (word & ~mask) | (uint64_t(value) << (idx % WORD_BITS));
+}
+
+void Bitmap::push_back(bool value) {
+    if (_size % WORD_BITS == 0) _words.push_back(0);
+    _words.back() |= uint64_t(value) << (_size % WORD_BITS);
+    _size++;
+}
+
+// Keeps the bits past the end cleared
+void Bitmap::resize(size_t size, bool value) {
+    size_t oldSize = _size;
+
+    _words.resize(wordsFor(size), value ? ~uint64_t(0) : 0);
+    _size = size;
+
+    if (value && size > oldSize && oldSize % WORD_BITS) {
+        _words[oldSize / WORD_BITS] |= ~uint64_t(0) << (oldSize % WORD_BITS);
+    }
+
+    if (_size % WORD_BITS) {
+        _words.back() &= ~(~uint64_t(0) << (_size % WORD_BITS));
+    }
+}
+
+size_t Bitmap::size() const { return _size; }
+
+size_t Bitmap::count() const {
+    size_t count = 0;
+    for (uint64_t word : _words) count += __builtin_popcountll(word);
+    return count;
+}
+
+const uint64_t* Bitmap::words() const { return _words.data(); }
+
+uint64_t* Bitmap::words() { return _words.data(); }
+
+size_t Bitmap::wordCount() const { return _words.size(); }
+
+Bitmap& Bitmap::operator&=(const Bitmap& other) {
+    if (other._size != _size)
+        throw std::invalid_argument("Bitmap sizes do not match");
+
+    for (size_t ii = 0; ii < _words.size(); ii++) {
+        _words[ii] &= other._words[ii];
+    }
+    return *this;
+}
+
+Bitmap& Bitmap::operator|=(const Bitmap& other) {
+    if (other._size != _size)
+        throw std::invalid_argument("Bitmap sizes do not match");
+
+    for (size_t ii = 0; ii < _words.size(); ii++) {
+        _words[ii] |= other._words[ii];
+    }
+    return *this;
+}
+
+Bitmap operator&(Bitmap a, const Bitmap& b) { return a &= b; }
+
+Bitmap operator|(Bitmap a, const Bitmap& b) { return a |= b; }
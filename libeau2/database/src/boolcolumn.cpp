@@ -0,0 +1,80 @@
+/**
+ * @file boolcolumn.cpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#include <sstream>
+#include <utility>
+
+#include "column.hpp"
+#include "payload.hpp"
+
+Column<bool>::Column() {}
+
+Column<bool>::Column(std::initializer_list<bool> ll) {
+    for (bool e : ll) push_back(e);
+}
+
+Column<bool>::Column(Bitmap bits) : _bits(std::move(bits)) {
+    _validity.resize(_bits.size());
+}
+
+bool Column<bool>::get(size_t idx) const { return _bits.get(idx); }
+
+void Column<bool>::set(size_t idx, bool val) {
+    _bits.set(idx, val);
+    _validity.set(idx, true);
+}
+
+void Column<bool>::push_back(bool val) {
+    _bits.push_back(val);
+    _validity.push_back(true);
+}
+
+void Column<bool>::pushMissing() {
+    _bits.push_back(false);
+    _validity.push_back(false);
+}
+
+void Column<bool>::resize(size_t size) {
+    _bits.resize(size);
+    _validity.resize(size);
+}
+
+size_t Column<bool>::count() const { return _bits.count(); }
+
+const Bitmap& Column<bool>::bits() const { return _bits; }
+
+void Column<bool>::andWith(const Column<bool>& other) { _bits &= other._bits; }
+
+void Column<bool>::orWith(const Column<bool>& other) { _bits |= other._bits; }
+
+size_t Column<bool>::size() const { return _bits.size(); }
+
+std::string Column<bool>::str() const {
+    std::stringstream ss;
+
+    for (size_t i = 0; i < size(); i++) {
+        ss << get(i);
+        if (i != size() - 1) {
+            ss << ", ";
+        }
+    }
+
+    return ss.str();
+}
+
+// The item count, then the bits packed 8 to a byte
+void Column<bool>::serialize(Serializer& ss) const {
+    Payload colData;
+    uint64_t count = size();
+
+    colData.addBytes(Serial::Type::Bool, &count, sizeof(count));
+    colData.addBytes(Serial::Type::Bool, _bits.words(), (count + 7) / 8);
+    colData.serialize(ss);
+}
+
+bool Column<bool>::canSerialize() const { return size() != 0; }
@@ -0,0 +1,390 @@
+/**
+ * @file columnfile.cpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#include "columnfile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include "bitmap.hpp"
+#include "column.hpp"
+#include "dataframe.hpp"
+
+namespace {
+// Appends to a file, keeping track of how much has been written
+class Writer {
+   private:
+    FILE* _file;           // file written to
+    uint64_t _offset = 0;  // bytes written so far
+    bool _ok = true;       // whether every write succeeded
+
+   public:
+    explicit Writer(FILE* file) : _file(file) {}
+
+    // Appends the bytes given
+    void put(const void* bytes, size_t size) {
+        if (size && fwrite(bytes, 1, size, _file) != size) _ok = false;
+        _offset += size;
+    }
+
+    // Appends size zero bytes
+    void zeros(size_t size) {
+        static const char ZEROS[CACHE_LINE_SIZE] = {};
+        while (size) {
+            size_t len = std::min(size, sizeof(ZEROS));
+            put(ZEROS, len);
+            size -= len;
+        }
+    }
+
+    // Pads the file to the next cache line and returns the offset there
+    uint64_t align() {
+        zeros((CACHE_LINE_SIZE - _offset % CACHE_LINE_SIZE) % CACHE_LINE_SIZE);
+        return _offset;
+    }
+
+    // Rewrites bytes already written at the given offset
+    void putAt(uint64_t offset, const void* bytes, size_t size) {
+        if (fseek(_file, offset, SEEK_SET) ||
+            fwrite(bytes, 1, size, _file) != size) {
+            _ok = false;
+        }
+    }
+
+    bool ok() const { return _ok; }
+};
+
+// Number of chunks needed for rows items of type T
+template <typename T>
+size_t chunkCount(size_t rows) {
+    return (rows + Chunk<T>::MASK) >> Chunk<T>::SHIFT;
+}
+
+// Writes every chunk of the column in full, the last one padded with zeros
+template <typename T>
+void writeChunks(Writer& out, const Column<T>& col,
+                 ColumnFile::ColumnHeader& header) {
+    header.data = out.align();
+    for (size_t ii = 0; ii < col.blocks(); ii++) {
+        Block<T> block = col.block(ii);
+        out.put(block.data(), block.size() * sizeof(T));
+        out.zeros(Chunk<T>::bytes() - block.size() * sizeof(T));
+    }
+    header.dataBytes = col.blocks() * Chunk<T>::bytes();
+}
+
+// Writes the min and max of every chunk, leaving out missing items
+template <typename T>
+void writeStats(Writer& out, const Column<T>& col,
+                ColumnFile::ColumnHeader& header) {
+    header.stats = out.align();
+    header.hasStats = 1;
+
+    const Validity& validity = col.validity();
+    for (size_t ii = 0; ii < col.blocks(); ii++) {
+        Block<T> block = col.block(ii);
+        size_t start = ii << Chunk<T>::SHIFT;
+        bool checkMissing = validity.anyMissing(start, block.size());
+
+        double range[2] = {std::numeric_limits<double>::infinity(),
+                           -std::numeric_limits<double>::infinity()};
+        for (size_t jj = 0; jj < block.size(); jj++) {
+            if (checkMissing && validity.isMissing(start + jj)) continue;
+            range[0] = std::min<double>(range[0], block[jj]);
+            range[1] = std::max<double>(range[1], block[jj]);
+        }
+        out.put(range, sizeof(range));
+    }
+}
+}  // namespace
+
+// Writes a placeholder for the headers first, they are filled in as each
+// column's sections are written and rewritten at the end
+bool ColumnFile::write(DataFrame& df, const char* filename, bool stats) {
+    if (!df._local) {
+        std::cerr << "Only local DataFrames can be written to a file\n";
+        return false;
+    }
+
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        std::cerr << "Could not open " << filename << " for writing\n";
+        return false;
+    }
+
+    size_t rows = df.nrows();
+    size_t cols = df.ncols();
+
+    Header header = {};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.rows = rows;
+    header.cols = cols;
+
+    std::vector<ColumnHeader> columns(cols, ColumnHeader{});
+    Writer out(file);
+    out.put(&header, sizeof(header));
+    out.put(columns.data(), cols * sizeof(ColumnHeader));
+
+    bool supported = true;
+    for (size_t ii = 0; ii < cols && supported; ii++) {
+        ColumnHeader& column = columns[ii];
+        column.type = df.getSchema().colType(ii);
+        ColumnInterface& data = *df._data[ii];
+
+        switch (column.type) {
+            case 'I': {
+                auto& col = static_cast<Column<int>&>(data);
+                writeChunks(out, col, column);
+                if (stats) writeStats(out, col, column);
+                break;
+            }
+            case 'D': {
+                auto& col = static_cast<Column<double>&>(data);
+                writeChunks(out, col, column);
+                if (stats) writeStats(out, col, column);
+                break;
+            }
+            case 'B': {
+                auto& col = static_cast<Column<bool>&>(data);
+                column.data = out.align();
+                column.dataBytes = col.bits().wordCount() * sizeof(uint64_t);
+                out.put(col.bits().words(), column.dataBytes);
+                break;
+            }
+            case 'S': {
+                // dictionary encoded and interned columns are written out
+                // item by item like any other
+                auto& col = static_cast<Column<ExtString>&>(data);
+                std::vector<char> arena;
+                Column<uint64_t> offsets;
+                for (size_t jj = 0; jj < rows; jj++) {
+                    std::string_view val = col.get(jj);
+                    offsets.push_back(arena.size());
+                    arena.insert(arena.end(), val.begin(), val.end());
+                    arena.push_back('\0');
+                }
+
+                column.arena = out.align();
+                column.arenaBytes = arena.size();
+                out.put(arena.data(), arena.size());
+                writeChunks(out, offsets, column);
+                break;
+            }
+            default:
+                std::cerr << "Cannot write column of type '" << column.type
+                          << "'\n";
+                supported = false;
+        }
+
+        const Bitmap* present = data.validity().present();
+        if (present && data.nullCount()) {
+            column.validity = out.align();
+            column.validityBytes = present->wordCount() * sizeof(uint64_t);
+            out.put(present->words(), column.validityBytes);
+        }
+    }
+
+    out.putAt(sizeof(header), columns.data(), cols * sizeof(ColumnHeader));
+    bool closed = fclose(file) == 0;
+    bool ok = out.ok() && closed && supported;
+    if (!ok) {
+        std::cerr << "Could not write " << filename << '\n';
+        remove(filename);
+    }
+
+    return ok;
+}
+
+// The mapping is writable but private, so Columns used in place can still be
+// modified
+ColumnFile::ColumnFile(const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size >= 0 &&
+        static_cast<size_t>(st.st_size) >= sizeof(Header)) {
+        size_t size = st.st_size;
+        void* map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                         fd, 0);
+        if (map != MAP_FAILED) {
+            _map = std::shared_ptr<void>(
+                map, [size](void* addr) { munmap(addr, size); });
+            _size = size;
+        }
+    }
+    close(fd);
+
+    if (!_map) return;
+    if (!_validate()) {
+        std::cerr << filename << " is not a valid column file\n";
+        _map.reset();
+    }
+}
+
+// Every section must lie within the file, and in place columns must start on
+// a cache line
+bool ColumnFile::_validate() {
+    _header = static_cast<const Header*>(_map.get());
+    if (memcmp(_header->magic, MAGIC, sizeof(MAGIC)) ||
+        _header->version != VERSION) {
+        return false;
+    }
+
+    size_t rows = _header->rows;
+    if (_header->cols > (_size - sizeof(Header)) / sizeof(ColumnHeader)) {
+        return false;
+    }
+    // Every row takes at least a bit of the file, which also keeps the sizes
+    // expected below from overflowing
+    if (rows > (_size - sizeof(Header)) * CHAR_BIT) return false;
+    _columns = reinterpret_cast<const ColumnHeader*>(_header + 1);
+
+    auto within = [this](uint64_t offset, uint64_t bytes) {
+        return offset <= _size && bytes <= _size - offset;
+    };
+    const char* base = static_cast<const char*>(_map.get());
+
+    for (size_t ii = 0; ii < _header->cols; ii++) {
+        const ColumnHeader& column = _columns[ii];
+        size_t chunks = 0;
+        size_t expected = 0;
+
+        switch (column.type) {
+            case 'I':
+                chunks = chunkCount<int>(rows);
+                expected = chunks * Chunk<int>::bytes();
+                break;
+            case 'D':
+                chunks = chunkCount<double>(rows);
+                expected = chunks * Chunk<double>::bytes();
+                break;
+            case 'B':
+                expected = (rows + Bitmap::WORD_BITS - 1) / Bitmap::WORD_BITS *
+                           sizeof(uint64_t);
+                break;
+            case 'S':
+                expected =
+                    chunkCount<uint64_t>(rows) * Chunk<uint64_t>::bytes();
+                if (!within(column.arena, column.arenaBytes)) return false;
+                if (column.arenaBytes &&
+                    base[column.arena + column.arenaBytes - 1] != '\0') {
+                    return false;
+                }
+                break;
+            default:
+                return false;
+        }
+
+        if (column.dataBytes != expected || column.data % CACHE_LINE_SIZE ||
+            !within(column.data, column.dataBytes)) {
+            return false;
+        }
+
+        // Strings are viewed at their offsets without further checks
+        if (column.type == 'S') {
+            const uint64_t* offsets =
+                reinterpret_cast<const uint64_t*>(base + column.data);
+            for (size_t jj = 0; jj < rows; jj++) {
+                if (offsets[jj] >= column.arenaBytes) return false;
+            }
+        }
+
+        size_t words = (rows + Bitmap::WORD_BITS - 1) / Bitmap::WORD_BITS;
+        if (column.validityBytes &&
+            (column.validityBytes != words * sizeof(uint64_t) ||
+             !within(column.validity, column.validityBytes))) {
+            return false;
+        }
+
+        if (column.hasStats &&
+            !within(column.stats, chunks * 2 * sizeof(double))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ColumnFile::isOpen() const { return _map != nullptr; }
+
+size_t ColumnFile::nrows() const { return _map ? _header->rows : 0; }
+
+size_t ColumnFile::ncols() const { return _map ? _header->cols : 0; }
+
+char ColumnFile::colType(size_t idx) const { return _columns[idx].type; }
+
+bool ColumnFile::chunkRange(size_t col, size_t chunk, double& min,
+                            double& max) const {
+    if (!_map || col >= ncols() || !_columns[col].hasStats) return false;
+
+    size_t chunks = _columns[col].type == 'I' ? chunkCount<int>(nrows())
+                                              : chunkCount<double>(nrows());
+    if (chunk >= chunks) return false;
+
+    const char* stats =
+        static_cast<const char*>(_map.get()) + _columns[col].stats;
+    double range[2];
+    memcpy(range, stats + chunk * sizeof(range), sizeof(range));
+    min = range[0];
+    max = range[1];
+
+    return true;
+}
+
+DFPtr ColumnFile::dataFrame() const {
+    if (!_map) return nullptr;
+
+    uint8_t* base = static_cast<uint8_t*>(_map.get());
+    size_t rows = nrows();
+    auto df = std::make_shared<DataFrame>();
+
+    for (size_t ii = 0; ii < ncols(); ii++) {
+        const ColumnHeader& column = _columns[ii];
+        ColIPtr col;
+
+        switch (column.type) {
+            case 'I':
+                col = std::make_shared<Column<int>>(_map, base + column.data,
+                                                    rows);
+                break;
+            case 'D':
+                col = std::make_shared<Column<double>>(
+                    _map, base + column.data, rows);
+                break;
+            case 'B':
+                col = std::make_shared<Column<bool>>(
+                    Bitmap(base + column.data, rows));
+                break;
+            case 'S':
+                col = std::make_shared<Column<ExtString>>(
+                    _map, reinterpret_cast<char*>(base + column.arena),
+                    column.arenaBytes, base + column.data, rows);
+                break;
+        }
+
+        if (column.validityBytes) {
+            col->setValidity(Bitmap(base + column.validity, rows));
+        }
+        df->_adoptCol(column.type, col);
+    }
+
+    return df;
+}
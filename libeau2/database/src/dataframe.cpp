@@ -8,26 +8,402 @@
 
 #include "dataframe.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <numeric>
 #include <stdexcept>
 #include <string>
-#include <thread>
+#include <string_view>
+#include <vector>
 
+#include "bitmap.hpp"
 #include "column.hpp"
+#include "executor.hpp"
 #include "kvstore.hpp"
 #include "row.hpp"
+#include "rowbatch.hpp"
 #include "rower.hpp"
 #include "schema.hpp"
 #include "sorer/column.h"  // from 4500ne
+#include "sorer/mapped.h"
+#include "sorer/parser.h"
+
+namespace {
+// SoR files are split into segments of at least this many bytes, each parsed
+// by its own task
+constexpr size_t SEGMENT_BYTES = 1 << 20;
+
+// Number of places in a SoR file its schema is guessed from
+constexpr size_t SCHEMA_SAMPLES = 8;
+
+// Number of blocks per thread a streamed SoR file may have parsed but not yet
+// pushed at once
+constexpr size_t BLOCKS_IN_FLIGHT = 2;
+
+// Bool and string columns can't be written to from several threads, they are
+// filled by appending to them in order
+bool isAppendOnly(char type) { return type == 'B' || type == 'S'; }
+
+// Creates a Column of the given schema type holding size unset items. Append
+// only columns start empty, string columns share the dictionary of the given
+// column if any.
+ColIPtr makeColumn(char type, const ColumnInterface& like, size_t size) {
+    switch (type) {
+        case 'I': {
+            auto col = std::make_shared<Column<int>>();
+            col->resize(size);
+            return col;
+        }
+        case 'B':
+            return std::make_shared<Column<bool>>();
+        case 'D': {
+            auto col = std::make_shared<Column<double>>();
+            col->resize(size);
+            return col;
+        }
+        case 'S': {
+            auto& strings = dynamic_cast<const Column<ExtString>&>(like);
+            if (strings.dict())
+                return std::make_shared<Column<ExtString>>(strings.dict());
+            return std::make_shared<Column<ExtString>>();
+        }
+        case 'F': {
+            auto col = std::make_shared<Column<float>>();
+            col->resize(size);
+            return col;
+        }
+        case 'L': {
+            auto col = std::make_shared<Column<int64_t>>();
+            col->resize(size);
+            return col;
+        }
+        default:
+            throw std::invalid_argument("Unsupported type");
+    }
+}
+
+// Copies the selected items of one batch of src into dst starting at out
+template <typename T>
+void gather(const ColumnInterface& src, ColumnInterface& dst, size_t start,
+            const Bitmap& selection, size_t out) {
+    auto& from = dynamic_cast<const Column<T>&>(src);
+    auto& to = dynamic_cast<Column<T>&>(dst);
+    Block<T> items = from.slice(start, selection.size());
+    const uint64_t* words = selection.words();
+
+    for (size_t word = 0; word < selection.wordCount(); word++) {
+        for (uint64_t bits = words[word]; bits; bits &= bits - 1) {
+            to.set(out++, items[word * 64 + __builtin_ctzll(bits)]);
+        }
+    }
+}
+
+// Appends the selected items of one batch of src to dst, batches must be
+// gathered in order. Encoded string columns share their dictionary and only
+// copy codes.
+void gatherAppend(char type, const ColumnInterface& src, ColumnInterface& dst,
+                  size_t start, const Bitmap& selection) {
+    const uint64_t* words = selection.words();
+
+    if (type == 'B') {
+        auto& from = dynamic_cast<const Column<bool>&>(src);
+        auto& to = dynamic_cast<Column<bool>&>(dst);
+
+        for (size_t word = 0; word < selection.wordCount(); word++) {
+            for (uint64_t bits = words[word]; bits; bits &= bits - 1) {
+                size_t idx = start + word * 64 + __builtin_ctzll(bits);
+                to.push_back(from.get(idx));
+            }
+        }
+        return;
+    }
+
+    auto& from = dynamic_cast<const Column<ExtString>&>(src);
+    auto& to = dynamic_cast<Column<ExtString>&>(dst);
+    bool codes = from.dict() && from.dict() == to.dict();
+
+    for (size_t word = 0; word < selection.wordCount(); word++) {
+        for (uint64_t bits = words[word]; bits; bits &= bits - 1) {
+            size_t idx = start + word * 64 + __builtin_ctzll(bits);
+            if (codes)
+                to.pushCode(from.code(idx));
+            else
+                to.push_back(from.get(idx));
+        }
+    }
+}
+
+void gatherColumn(char type, const ColumnInterface& src, ColumnInterface& dst,
+                  size_t start, const Bitmap& selection, size_t out) {
+    switch (type) {
+        case 'I':
+            return gather<int>(src, dst, start, selection, out);
+        case 'D':
+            return gather<double>(src, dst, start, selection, out);
+        case 'F':
+            return gather<float>(src, dst, start, selection, out);
+        case 'L':
+            return gather<int64_t>(src, dst, start, selection, out);
+        default:
+            throw std::invalid_argument("Unsupported type");
+    }
+}
+
+// Schema type of the Column a SoR column is loaded into, floats are widened
+// to doubles
+char sorType(ne::ColumnType type) {
+    switch (type) {
+        case ne::ColumnType::STRING:
+            return 'S';
+        case ne::ColumnType::INTEGER:
+            return 'I';
+        case ne::ColumnType::FLOAT:
+            return 'D';
+        case ne::ColumnType::BOOL:
+            return 'B';
+        default:
+            throw std::invalid_argument("Unsupported type");
+    }
+}
+
+// Appends every item of src to dst, keeping missing items missing. Values are
+// copied a Block at a time.
+template <typename T>
+void appendAll(const ColumnInterface& src, ColumnInterface& dst) {
+    auto& from = dynamic_cast<const Column<T>&>(src);
+    auto& to = dynamic_cast<Column<T>&>(dst);
+    size_t start = to.size();
+
+    for (size_t ii = 0; ii < from.blocks(); ii++) {
+        Block<T> block = from.block(ii);
+        to.append(block.data(), block.size());
+    }
+
+    if (!from.nullCount()) return;
+    for (size_t ii = 0; ii < from.size(); ii++) {
+        if (from.isMissing(ii)) to.setMissing(start + ii);
+    }
+}
+
+template <>
+void appendAll<bool>(const ColumnInterface& src, ColumnInterface& dst) {
+    auto& from = dynamic_cast<const Column<bool>&>(src);
+    auto& to = dynamic_cast<Column<bool>&>(dst);
+
+    for (size_t ii = 0; ii < from.size(); ii++) {
+        if (from.isMissing(ii))
+            to.pushMissing();
+        else
+            to.push_back(from.get(ii));
+    }
+}
+
+template <>
+void appendAll<ExtString>(const ColumnInterface& src, ColumnInterface& dst) {
+    auto& from = dynamic_cast<const Column<ExtString>&>(src);
+    auto& to = dynamic_cast<Column<ExtString>&>(dst);
+
+    for (size_t ii = 0; ii < from.size(); ii++) {
+        if (from.isMissing(ii))
+            to.pushMissing();
+        else
+            to.push_back(from.get(ii));
+    }
+}
+
+void appendColumn(char type, const ColumnInterface& src, ColumnInterface& dst) {
+    switch (type) {
+        case 'S':
+            return appendAll<ExtString>(src, dst);
+        case 'I':
+            return appendAll<int>(src, dst);
+        case 'D':
+            return appendAll<double>(src, dst);
+        case 'B':
+            return appendAll<bool>(src, dst);
+        default:
+            throw std::invalid_argument("Unsupported type");
+    }
+}
+
+// Creates an empty Column for a SoR column of the given type
+ColIPtr makeSorColumn(ne::ColumnType type) {
+    switch (sorType(type)) {
+        case 'S':
+            return std::make_shared<Column<ExtString>>();
+        case 'I':
+            return std::make_shared<Column<int>>();
+        case 'D':
+            return std::make_shared<Column<double>>();
+        default:
+            return std::make_shared<Column<bool>>();
+    }
+}
+
+// Copies a 4500ne column into a new Column, reading its arrays directly
+// instead of through a virtual call and bounds check per entry
+ColIPtr convertSorColumn(ne::BaseColumn* basecol) {
+    const bool* present = basecol->_entry_present;
+    size_t length = basecol->getLength();
+
+    switch (basecol->getType()) {
+        case ne::ColumnType::INTEGER: {
+            auto col = std::make_shared<Column<int>>();
+            col->seal();
+            // missing entries hold 0, so the values are copied in bulk
+            col->append(dynamic_cast<ne::IntegerColumn*>(basecol)->_entries,
+                        length);
+            for (size_t ii = 0; ii < length; ii++) {
+                if (!present[ii]) col->setMissing(ii);
+            }
+            return col;
+        }
+        case ne::ColumnType::FLOAT: {
+            auto col = std::make_shared<Column<double>>();
+            const float* entries =
+                dynamic_cast<ne::FloatColumn*>(basecol)->_entries;
+            for (size_t ii = 0; ii < length; ii++) {
+                if (present[ii])
+                    col->push_back(entries[ii]);
+                else
+                    col->pushMissing();
+            }
+            return col;
+        }
+        case ne::ColumnType::BOOL: {
+            auto col = std::make_shared<Column<bool>>();
+            const bool* entries =
+                dynamic_cast<ne::BoolColumn*>(basecol)->_entries;
+            for (size_t ii = 0; ii < length; ii++) {
+                if (present[ii])
+                    col->push_back(entries[ii]);
+                else
+                    col->pushMissing();
+            }
+            return col;
+        }
+        case ne::ColumnType::STRING: {
+            auto col = std::make_shared<Column<ExtString>>();
+            const char** entries =
+                dynamic_cast<ne::StringColumn*>(basecol)->_entries;
+            for (size_t ii = 0; ii < length; ii++) {
+                if (present[ii])
+                    col->push_back(std::string_view(entries[ii]));
+                else
+                    col->pushMissing();
+            }
+            return col;
+        }
+        default:
+            throw std::invalid_argument("Unsupported type");
+    }
+}
+
+// Receives parsed SoR fields straight into eau2 Columns, the column types are
+// fixed so the casts need no checking. The Columns are sealed from the start,
+// so that chunks are encoded as they fill rather than all held plain until
+// parsing ends.
+class ColumnBuilder : public ne::FieldSink {
+   public:
+    std::vector<ColIPtr> columns;  // parsed columns in schema order
+
+    ColumnBuilder(const ne::ColumnType* types, size_t width) {
+        columns.reserve(width);
+        for (size_t ii = 0; ii < width; ii++) {
+            columns.push_back(makeSorColumn(types[ii]));
+            columns.back()->seal();
+        }
+    }
+
+    void appendString(size_t column, const char* str, size_t length) override {
+        static_cast<Column<ExtString>&>(*columns[column])
+            .push_back(std::string_view(str, length));
+    }
+
+    void appendInt(size_t column, int value) override {
+        static_cast<Column<int>&>(*columns[column]).push_back(value);
+    }
+
+    void appendFloat(size_t column, float value) override {
+        static_cast<Column<double>&>(*columns[column]).push_back(value);
+    }
+
+    void appendBool(size_t column, bool value) override {
+        static_cast<Column<bool>&>(*columns[column]).push_back(value);
+    }
+
+    void appendMissing(size_t column) override {
+        columns[column]->pushMissing();
+    }
+};
+
+// Parses every line in [begin, end) into the sink, the last one need not end
+// in a newline
+void parseLines(ne::SorParser& parser, ne::FieldSink& sink, const char* begin,
+                const char* end) {
+    while (begin < end) {
+        auto newline =
+            static_cast<const char*>(memchr(begin, '\n', end - begin));
+        if (!newline) newline = end;
+
+        parser.parseLine(begin, newline - begin, &sink);
+        begin = newline + 1;
+    }
+}
+
+// Guesses the schema of a SoR file from lines at evenly spaced places in it at
+// once, widening each column's type to fit every sample. Returns false if no
+// columns were found. The sampled lines are parsed again with the rest of the
+// file: their values can't be kept until every sample has been merged, as a
+// later one may widen a column, and there are at most SCHEMA_SAMPLES times
+// GUESS_SCHEMA_LINES of them whatever the size of the file, still in memory.
+bool guessSorSchema(ne::MappedFile& file, Executor& exec,
+                    std::vector<ne::ColumnType>& types) {
+    const char* data = file.getData();
+    size_t samples = std::min(SCHEMA_SAMPLES, file.getSize() / SEGMENT_BYTES);
+    samples = std::max<size_t>(samples, 1);
+    std::vector<size_t> bounds(samples + 1);
+    file.split(0, file.getSize(), samples, bounds.data());
+
+    std::vector<ne::SorParser> guessers(samples);
+    TaskGroup group(exec);
+    for (size_t ii = 0; ii < samples; ii++) {
+        group.run([&guessers, &bounds, data, ii] {
+            guessers[ii].guessLines(data + bounds[ii],
+                                    bounds[ii + 1] - bounds[ii],
+                                    ne::SorParser::GUESS_SCHEMA_LINES);
+        });
+    }
+    group.wait();
+
+    ne::SorParser& guesser = guessers[0];
+    for (size_t ii = 1; ii < samples; ii++) guesser.mergeSchema(&guessers[ii]);
+    if (!guesser._num_columns) return false;
+    guesser.initializeColumns();
+
+    types.assign(guesser._typeGuesses,
+                 guesser._typeGuesses + guesser._num_columns);
+    return true;
+}
+}  // namespace
 
 // Default constructor is a local DataFrame
 DataFrame::DataFrame() : DataFrame(Schema(), true) {}
 
 /** Create a data frame with the same columns as the given df but with no
  * rows or rownmaes */
-DataFrame::DataFrame(const DataFrame& df) : DataFrame(df._schema, df._local) {}
+DataFrame::DataFrame(const DataFrame& df) : DataFrame(df._schema, df._local) {
+    _schema.clearRows();
+}
 
 /** Create a data frame from a schema and columns. All columns are created
  * empty. */
@@ -40,7 +416,9 @@ DataFrame::DataFrame(const Schema& schema, bool local)
             type = schema.colType(ii);
             switch (type) {
                 case 'I':
+                    // rows are appended, so chunks are encoded as they fill
                     _data.push_back(std::make_shared<Column<int>>());
+                    _data.back()->seal();
                     break;
                 case 'B':
                     _data.push_back(std::make_shared<Column<bool>>());
@@ -80,10 +458,14 @@ double DataFrame::getDouble(size_t col, size_t row) {
     return getVal<double>(col, row);
 }
 
-ExtString DataFrame::getString(size_t col, size_t row) {
+std::string_view DataFrame::getString(size_t col, size_t row) {
     return getVal<ExtString>(col, row);
 }
 
+bool DataFrame::isMissing(size_t col, size_t row) {
+    return _data.at(col)->isMissing(row);
+}
+
 /** Set the fields of the given row object with values from the columns at
  * the given offset.  If the row is not form the same schema as the
  * dataframe, results are undefined.
@@ -96,6 +478,11 @@ void DataFrame::fillRow(size_t idx, Row& row) {
 
     row.setIdx(idx);
     for (size_t ii = 0; ii < _schema.width(); ii++) {
+        if (_data[ii]->isMissing(idx)) {
+            row.setMissing(ii);
+            continue;
+        }
+
         switch (_schema.colType(ii)) {
             case 'I':
                 row.set(ii, getInt(ii, idx));
@@ -117,6 +504,12 @@ void DataFrame::fillRow(size_t idx, Row& row) {
  *  the right schema and be filled with values, otherwise undedined.  */
 void DataFrame::add_row(Row& row) {
     for (size_t ii = 0; ii < _schema.width(); ii++) {
+        if (row.isMissing(ii)) {
+            _data[ii]->pushMissing();
+            _schema.setNullable(ii, true);
+            continue;
+        }
+
         switch (_schema.colType(ii)) {
             case 'I':
                 dynamic_cast<Column<int>&>(*_data[ii])
@@ -148,166 +541,395 @@ size_t DataFrame::ncols() { return _schema.width(); }
 
 /** Visit rows in order */
 void DataFrame::map(Rower& r) {
-    for (size_t ii = 0; ii < _schema.length(); ii++) {
-        Row row{_schema};
-        fillRow(ii, row);
-        r.accept(row);
+    size_t length = _schema.length();
+    size_t batchSize = RowBatch::maxSize(_schema);
+
+    for (size_t start = 0; start < length; start += batchSize) {
+        RowBatch batch(*this, start, std::min(batchSize, length - start));
+        r.acceptBatch(batch);
     }
 }
 
 /** Create a new dataframe, constructed from rows for which the given Rower
  * returned true from its accept method. */
-DataFrame& DataFrame::filter(Rower& r) {
-    DataFrame* ret = new DataFrame(_schema);
+DFPtr DataFrame::filter(Rower& r) {
+    size_t length = _schema.length();
+    size_t batchSize = RowBatch::maxSize(_schema);
+    size_t numBatches = (length + batchSize - 1) / batchSize;
+
+    // Evaluate the predicate in parallel, keeping a selection bitmap and the
+    // number of surviving rows for each batch
+    std::vector<Bitmap> selections(numBatches);
+    std::vector<size_t> offsets(numBatches + 1, 0);
+    _mapBatches(r, [&selections, &offsets, batchSize](RowBatch& batch) {
+        size_t idx = batch.start() / batchSize;
+        selections[idx] = batch.selection();
+        offsets[idx + 1] = selections[idx].count();
+    });
+
+    // Each batch's survivors start where the previous batch's end
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    size_t total = offsets.back();
+
+    auto ret = std::make_shared<DataFrame>();
+    ret->_schema = _schema;
+    ret->_schema.clearRows();
+    for (size_t ii = 0; ii < total; ii++) ret->_schema.addRow(nullptr);
 
-    for (size_t ii = 0; ii < _schema.length(); ii++) {
-        Row row = {_schema};
-        fillRow(ii, row);
-        if (r.accept(row)) ret->add_row(row);
+    for (size_t ii = 0; ii < _schema.width(); ii++) {
+        ret->_data.push_back(
+            makeColumn(_schema.colType(ii), *_data[ii], total));
     }
 
-    return *ret;
-}
+    // Gather the survivors column at a time, batches write disjoint ranges
+    // except in append only columns, which are filled by a single task each
+    TaskGroup group;
+    for (size_t ii = 0; ii < numBatches; ii++) {
+        if (offsets[ii] == offsets[ii + 1]) continue;
+
+        group.run([this, &ret, &selections, &offsets, batchSize, ii] {
+            for (size_t col = 0; col < _schema.width(); col++) {
+                if (isAppendOnly(_schema.colType(col))) continue;
+                gatherColumn(_schema.colType(col), *_data[col],
+                             *ret->_data[col], ii * batchSize, selections[ii],
+                             offsets[ii]);
+            }
+        });
+    }
 
-/** This method clones the Rower and executes the map in parallel. Join is
- * used at the end to merge the results. */
-void DataFrame::pmap(Rower& r) {
-    // try to get the max number of threads this configuration can run
-    unsigned int numThreads = std::thread::hardware_concurrency();
-    numThreads = numThreads ? numThreads : 4;  // default to 4
-    size_t length = _schema.length();
-    size_t partitionSize = length / numThreads;  // partition between threads
+    for (size_t col = 0; col < _schema.width(); col++) {
+        char type = _schema.colType(col);
+        if (!isAppendOnly(type)) continue;
 
-    while (partitionSize < 1 && numThreads > 1) {
-        partitionSize = length / --numThreads;
+        group.run([this, &ret, &selections, batchSize, numBatches, col, type] {
+            for (size_t ii = 0; ii < numBatches; ii++) {
+                gatherAppend(type, *_data[col], *ret->_data[col],
+                             ii * batchSize, selections[ii]);
+            }
+        });
+    }
+    group.wait();
+
+    // Carry over missing values, skipping batches that have none
+    for (size_t col = 0; col < _schema.width(); col++) {
+        if (!_data[col]->nullCount()) continue;
+
+        const Validity& src = _data[col]->validity();
+        for (size_t ii = 0; ii < numBatches; ii++) {
+            size_t start = ii * batchSize;
+            if (!src.anyMissing(start, std::min(batchSize, length - start)))
+                continue;
+
+            size_t out = offsets[ii];
+            for (size_t jj = 0; jj < selections[ii].size(); jj++) {
+                if (!selections[ii].get(jj)) continue;
+                if (src.isMissing(start + jj)) {
+                    ret->_data[col]->setMissing(out);
+                }
+                out++;
+            }
+        }
     }
 
-    // Create Rowers per thread
-    Rower* rowers[numThreads];
-    std::thread threads[numThreads];
+    // The gathered columns are complete, encode them once
+    for (ColIPtr& col : ret->_data) col->seal();
 
-    // use a lambda to map one thread's deligated partition
-    auto partialMap = [this](Rower* rower, size_t start, size_t end) {
-        for (size_t ii = start; ii < end; ii++) {
-            Row row{_schema};
-            fillRow(ii, row);
-            rower->accept(row);
-        }
-    };
+    return ret;
+}
 
-    size_t start, end;
-    for (size_t ii = 0; ii < numThreads; ii++) {
-        if (ii == numThreads - 1)
-            rowers[ii] = &r;
-        else
-            rowers[ii] = r.clone();
+/** This method clones the Rower and executes the map in parallel. Join is
+ * used at the end to merge the results. */
+void DataFrame::pmap(Rower& r) { _mapBatches(r, nullptr); }
 
-        start = (numThreads - ii - 1) * partitionSize;
-        end = ii == 0 ? length : start + partitionSize;
+// Runs the Rower over every batch on the global Executor, then joins the
+// clones back into it
+void DataFrame::_mapBatches(Rower& r,
+                            const std::function<void(RowBatch&)>& after) {
+    Executor& exec = Executor::global();
+    size_t length = _schema.length();
+    size_t batchSize = RowBatch::maxSize(_schema);
+
+    // Rowers are cloned lazily, one per worker that actually picks up a
+    // batch. A worker calling pmap keeps using the original Rower. The clones
+    // are freed if a batch throws.
+    std::vector<std::unique_ptr<Rower>> clones(exec.size());
+    size_t callerIdx = exec.workerIdx();
+
+    {
+        TaskGroup group(exec);
+        for (size_t start = 0; start < length; start += batchSize) {
+            size_t len = std::min(batchSize, length - start);
+
+            group.run([this, &exec, &clones, &r, &after, callerIdx, start,
+                       len] {
+                size_t idx = exec.workerIdx();
+                std::unique_ptr<Rower>& clone = clones[idx];
+                if (idx != callerIdx && !clone) clone.reset(r.clone());
+                Rower* rower = idx == callerIdx ? &r : clone.get();
+
+                RowBatch batch(*this, start, len);
+                rower->acceptBatch(batch);
+                if (after) after(batch);
+            });
+        }
+        group.wait();
+    }
 
-        // split off thread
-        threads[ii] = std::thread(partialMap, rowers[ii], start, end);
+    // Fold the results pairwise as a tree, with the original Rower first so
+    // that it is the last one joined on
+    std::vector<Rower*> results{&r};
+    for (std::unique_ptr<Rower>& clone : clones) {
+        if (clone) results.push_back(clone.release());
     }
 
-    // Join threads and fold results
-    for (size_t ii = 0; ii < numThreads; ii++) {
-        threads[ii].join();
-        if (ii != 0) {
-            rowers[ii]->join_delete(rowers[ii - 1]);
-            rowers[ii - 1] = nullptr;
+    for (size_t stride = 1; stride < results.size(); stride *= 2) {
+        TaskGroup group(exec);
+        for (size_t ii = 0; ii + stride < results.size(); ii += 2 * stride) {
+            group.run([&results, ii, stride] {
+                results[ii]->join_delete(results[ii + stride]);
+            });
         }
+        group.wait();
     }
 }
 
 /**
- * @brief Creates a database from 4500ne's parsers. There's some data overhead
- * that would be solved by refactoring our code or theirs to share the same
- * column types.
+ * @brief Creates a database from 4500ne's parsers. Each column is copied
+ * straight out of its arrays and then freed, so only one column is held
+ * twice at a time.
  *
  * @param key   the key in the store
  * @param kv    the store
- * @param set   the set of columns
+ * @param set   the set of columns, left without columns
  */
 void DataFrame::fromColumnSet(Key* key, KVStore* kv, ne::ColumnSet* set) {
     auto df = std::make_shared<DataFrame>();
 
-    for (size_t i = 0; i < set->getLength(); i++) {
-        ne::BaseColumn* basecol = set->getColumn(i);
+    for (size_t ii = 0; ii < set->getLength(); ii++) {
+        ne::BaseColumn* basecol = set->getColumn(ii);
+        df->_adoptCol(sorType(basecol->getType()), convertSorColumn(basecol));
 
-        // TODO(mike) this loop is porrly written
-        if (basecol->getType() == ne::ColumnType::STRING) {
-            auto newCol = std::make_shared<Column<ExtString>>();
+        delete basecol;
+        set->_columns[ii] = nullptr;
+    }
 
-            ne::StringColumn* col = dynamic_cast<ne::StringColumn*>(basecol);
+    kv->push(*key, df);
+}
 
-            for (size_t i = 0; i < col->getLength(); i++) {
-                if (col->isEntryPresent(i))
-                    newCol->push_back(
-                        std::make_shared<std::string>(col->getEntry(i)));
-                else {
-                    // TODO(mike) how to handle missing entries?
-                    // newCol->push_back()
-                }
+// The file is mapped rather than read. Its schema is guessed from several
+// samples in parallel, then it is split at line boundaries and every segment
+// is parsed into its own Columns on the global Executor. The segments
+// are then appended in order, one task per column.
+DFPtr DataFrame::fromFile(const char* filename, const Key& key, KVStore* kv) {
+    ne::MappedFile file(filename);
+    if (!file.isOpen() || !file.getSize()) {
+        std::cerr << "Could not read SoR file " << filename << std::endl;
+        return nullptr;
+    }
+
+    Executor& exec = Executor::global();
+    const char* data = file.getData();
+
+    std::vector<ne::ColumnType> guessed;
+    if (!guessSorSchema(file, exec, guessed)) {
+        std::cerr << "No columns found in SoR file " << filename << std::endl;
+        return nullptr;
+    }
+    const ne::ColumnType* types = guessed.data();
+    size_t width = guessed.size();
+
+    TaskGroup group(exec);
+    size_t parts = std::min(exec.size() * 4, file.getSize() / SEGMENT_BYTES);
+    parts = std::max<size_t>(parts, 1);
+    std::vector<size_t> bounds(parts + 1);
+    file.split(0, file.getSize(), parts, bounds.data());
+
+    std::vector<std::unique_ptr<ColumnBuilder>> segments(parts);
+    for (size_t ii = 0; ii < parts; ii++) {
+        group.run([&segments, &bounds, data, types, width, ii] {
+            ne::SorParser parser(types, width);
+            segments[ii] = std::make_unique<ColumnBuilder>(types, width);
+            parseLines(parser, *segments[ii], data + bounds[ii],
+                       data + bounds[ii + 1]);
+        });
+    }
+    group.wait();
+
+    // The first segment's Columns are kept and the others appended to them
+    for (size_t col = 0; col < width; col++) {
+        group.run([&segments, types, col] {
+            ColumnInterface& dst = *segments[0]->columns[col];
+            for (size_t ii = 1; ii < segments.size(); ii++) {
+                appendColumn(sorType(types[col]), *segments[ii]->columns[col],
+                             dst);
+                segments[ii]->columns[col].reset();
             }
+        });
+    }
+    group.wait();
 
-            df->addCol(newCol);
+    auto df = std::make_shared<DataFrame>();
+    for (size_t col = 0; col < width; col++) {
+        df->_adoptCol(sorType(types[col]), segments[0]->columns[col]);
+    }
 
-        } else if (basecol->getType() == ne::ColumnType::INTEGER) {
-            auto newCol = std::make_shared<Column<int>>();
+    if (kv) kv->push(key, df);
 
-            ne::IntegerColumn* col = dynamic_cast<ne::IntegerColumn*>(basecol);
+    return df;
+}
 
-            for (size_t i = 0; i < col->getLength(); i++) {
-                if (col->isEntryPresent(i))
-                    newCol->push_back(col->getEntry(i));
-                else {
-                    // newCol->push_back()
-                }
-            }
+// The calling thread only finds where each block of rows ends, the blocks are
+// parsed and pushed on the global Executor. It stops to wait, or to help, once
+// too many blocks are in flight, so that the rest of the file is not parsed
+// faster than it can be sent. A block stays in flight until the network is
+// done with its Put, not just until it is queued.
+DFPtr DataFrame::streamFile(const char* filename, const Key& key, KVStore& kv,
+                            size_t nodes, size_t blockRows) {
+    if (!nodes || !blockRows) {
+        throw std::invalid_argument("Blocks need a node and a row");
+    }
+    if (key.home() != kv.idx()) {
+        throw std::invalid_argument("Directory must be homed on this node");
+    }
 
-            df->addCol(newCol);
+    ne::MappedFile file(filename);
+    if (!file.isOpen() || !file.getSize()) {
+        std::cerr << "Could not read SoR file " << filename << std::endl;
+        return nullptr;
+    }
 
-        } else if (basecol->getType() == ne::ColumnType::FLOAT) {
-            auto newCol = std::make_shared<Column<float>>();
+    Executor& exec = Executor::global();
+    std::vector<ne::ColumnType> guessed;
+    if (!guessSorSchema(file, exec, guessed)) {
+        std::cerr << "No columns found in SoR file " << filename << std::endl;
+        return nullptr;
+    }
+    const ne::ColumnType* types = guessed.data();
+    size_t width = guessed.size();
+
+    std::mutex lock;
+    std::condition_variable released;
+    size_t inFlight = 0;
+    size_t maxInFlight = exec.size() * BLOCKS_IN_FLIGHT;
+    auto release = [&lock, &released, &inFlight] {
+        std::lock_guard<std::mutex> guard(lock);
+        inFlight--;
+        released.notify_all();
+    };
 
-            ne::FloatColumn* col = dynamic_cast<ne::FloatColumn*>(basecol);
+    // a deque keeps the lengths in place as blocks are added
+    std::deque<size_t> lengths;
+    std::deque<std::string> names;
+
+    const char* data = file.getData();
+    const char* end = data + file.getSize();
+    TaskGroup group(exec);
+    for (const char* begin = data; begin < end;) {
+        const char* stop = begin;
+        for (size_t ii = 0; ii < blockRows && stop < end; ii++) {
+            auto newline =
+                static_cast<const char*>(memchr(stop, '\n', end - stop));
+            stop = newline ? newline + 1 : end;
+        }
 
-            for (size_t i = 0; i < col->getLength(); i++) {
-                if (col->isEntryPresent(i))
-                    newCol->push_back(col->getEntry(i));
-                else {
-                    // newCol->push_back()
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            while (inFlight >= maxInFlight) {
+                guard.unlock();
+                bool ran = exec.tryRunOne();
+                guard.lock();
+                if (!ran) {
+                    released.wait_for(guard, std::chrono::milliseconds(1));
                 }
             }
+            inFlight++;
+        }
 
-            df->addCol(newCol);
-
-        } else if (basecol->getType() == ne::ColumnType::BOOL) {
-            auto newCol = std::make_shared<Column<bool>>();
-
-            ne::BoolColumn* col = dynamic_cast<ne::BoolColumn*>(basecol);
-
-            for (size_t i = 0; i < col->getLength(); i++) {
-                if (col->isEntryPresent(i))
-                    newCol->push_back(col->getEntry(i));
-                else {
-                    // newCol->push_back()
+        size_t blockIdx = names.size();
+        names.push_back(key.name() + "_" + std::to_string(blockIdx));
+        lengths.push_back(0);
+
+        Key blockKey(names.back(), 1 + blockIdx % nodes);
+        size_t& length = lengths.back();
+        group.run([&kv, &release, &length, blockKey, types, width, begin,
+                   stop] {
+            try {
+                ne::SorParser parser(types, width);
+                ColumnBuilder builder(types, width);
+                parseLines(parser, builder, begin, stop);
+
+                auto block = std::make_shared<DataFrame>();
+                for (size_t col = 0; col < width; col++) {
+                    block->_adoptCol(sorType(types[col]),
+                                     builder.columns[col]);
                 }
+                length = block->nrows();
+                kv.push(blockKey, block, release);
+            } catch (...) {
+                release();
+                throw;
             }
+        });
 
-            df->addCol(newCol);
+        begin = stop;
+    }
+    // Blocks still being sent refer to release, so they are waited for even
+    // if parsing failed
+    auto drain = [&lock, &released, &inFlight] {
+        std::unique_lock<std::mutex> guard(lock);
+        released.wait(guard, [&inFlight] { return inFlight == 0; });
+    };
+    try {
+        group.wait();
+    } catch (...) {
+        drain();
+        throw;
+    }
+    drain();
 
-        } else {  // unknown type TODO(mike) handle this
-            assert(false);
+    // Rows are found by block size, so only the last block may be short
+    for (size_t ii = 0; ii + 1 < lengths.size(); ii++) {
+        if (lengths[ii] != blockRows) {
+            throw std::runtime_error("Streamed block is not full");
         }
     }
 
-    kv->push(*key, df);
+    std::string typeStr;
+    for (size_t col = 0; col < width; col++) typeStr += sorType(types[col]);
+    Schema schema(typeStr.c_str(), false);
+    schema.setLength(std::accumulate(lengths.begin(), lengths.end(),
+                                     static_cast<size_t>(0)));
+
+    auto nameCol = std::make_shared<Column<ExtString>>();
+    auto homeCol = std::make_shared<Column<int64_t>>();
+    for (size_t ii = 0; ii < names.size(); ii++) {
+        nameCol->push_back(std::string_view(names[ii]));
+        homeCol->push_back(1 + ii % nodes);
+    }
+
+    auto df = std::make_shared<DataFrame>(schema, false);
+    df->_kv = &kv;
+    df->_blkSize = blockRows;
+    df->addCol(nameCol);
+    df->addCol(homeCol);
+
+    kv.insert(key, df);
+
+    return df;
 }
 
-// To be implemented, will use the 4500NE parser
-DFPtr fromFile(const char* filename, const Key& key, KVStore* kv) {
-    return nullptr;
+// The first column sets the number of rows. The column is complete, so it is
+// sealed.
+void DataFrame::_adoptCol(char type, ColIPtr col) {
+    if (_data.empty()) {
+        for (size_t ii = 0; ii < col->size(); ii++) _schema.addRow(nullptr);
+    } else if (col->size() != _schema.length()) {
+        throw std::invalid_argument("Column does not match schema length");
+    }
+
+    col->seal();
+    _schema.addCol(type, nullptr, col->nullCount() > 0);
+    _data.push_back(col);
 }
 
 void DataFrame::print() {
@@ -0,0 +1,178 @@
+/**
+ * @file executor.cpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#include "executor.hpp"
+
+#include <utility>
+
+namespace {
+// Pool and index of the worker running on this thread, if any
+thread_local const Executor* currentPool = nullptr;
+thread_local size_t currentIdx = Executor::NOT_A_WORKER;
+}  // namespace
+
+Executor::Executor(size_t numThreads) {
+    if (!numThreads) numThreads = std::thread::hardware_concurrency();
+    if (!numThreads) numThreads = 4;  // default to 4
+
+    _queues.reserve(numThreads);
+    for (size_t ii = 0; ii < numThreads; ii++) {
+        _queues.push_back(std::make_unique<Queue>());
+    }
+
+    _threads.reserve(numThreads);
+    for (size_t ii = 0; ii < numThreads; ii++) {
+        _threads.emplace_back(&Executor::_work, this, ii);
+    }
+}
+
+Executor::~Executor() {
+    {
+        std::lock_guard<std::mutex> lock(_sleepLock);
+        _done = true;
+    }
+    _wake.notify_all();
+
+    for (std::thread& thread : _threads) thread.join();
+}
+
+Executor& Executor::global() {
+    static Executor pool;
+    return pool;
+}
+
+size_t Executor::size() const { return _threads.size(); }
+
+size_t Executor::workerIdx() const {
+    return currentPool == this ? currentIdx : NOT_A_WORKER;
+}
+
+// Workers push to their own queue so that related tasks stay on one thread
+void Executor::submit(Task task) {
+    size_t idx = workerIdx();
+    if (idx == NOT_A_WORKER) idx = _nextQueue++ % _queues.size();
+
+    {
+        std::lock_guard<std::mutex> lock(_queues[idx]->lock);
+        _queues[idx]->tasks.push_back(std::move(task));
+    }
+    _queued++;
+
+    // taking the lock orders this with a worker about to sleep
+    { std::lock_guard<std::mutex> lock(_sleepLock); }
+    _wake.notify_one();
+}
+
+bool Executor::tryRunOne() {
+    size_t idx = workerIdx();
+    return idx != NOT_A_WORKER && _runOne(idx);
+}
+
+// Sleeps with the idle workers, so it wakes for new tasks as well
+void Executor::helpUntil(const std::function<bool()>& done) {
+    size_t idx = workerIdx();
+    while (!done()) {
+        if (_runOne(idx)) continue;
+
+        std::unique_lock<std::mutex> lock(_sleepLock);
+        _wake.wait(lock, [this, &done] { return done() || _queued; });
+    }
+}
+
+void Executor::notifyHelpers() {
+    // taking the lock orders this with a helper about to sleep
+    { std::lock_guard<std::mutex> lock(_sleepLock); }
+    _wake.notify_all();
+}
+
+void Executor::_work(size_t idx) {
+    currentPool = this;
+    currentIdx = idx;
+
+    while (true) {
+        if (_runOne(idx)) continue;
+
+        std::unique_lock<std::mutex> lock(_sleepLock);
+        if (_done && !_queued) break;
+        _wake.wait(lock, [this] { return _done || _queued; });
+    }
+}
+
+// Newest task from our own queue first, oldest task from everyone else's
+bool Executor::_runOne(size_t idx) {
+    Task task;
+
+    for (size_t ii = 0; ii < _queues.size() && !task; ii++) {
+        Queue& queue = *_queues[(idx + ii) % _queues.size()];
+        std::lock_guard<std::mutex> lock(queue.lock);
+        if (queue.tasks.empty()) continue;
+
+        if (ii == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        _queued--;
+    }
+
+    if (!task) return false;
+
+    task();
+    return true;
+}
+
+TaskGroup::TaskGroup(Executor& exec) : _exec(exec), _pending(0) {}
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+    }
+}
+
+void TaskGroup::run(Task task) {
+    _pending++;
+
+    _exec.submit([this, task = std::move(task)] {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(_lock);
+            if (!_error) _error = std::current_exception();
+        }
+
+        // the waiter may destroy the group as soon as it sees 0, so the last
+        // task must not touch it after releasing the lock
+        Executor& exec = _exec;
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            if (--_pending) return;
+            _idle.notify_all();
+        }
+        exec.notifyHelpers();
+    });
+}
+
+void TaskGroup::wait() {
+    auto finished = [this] { return _pending == 0; };
+
+    // keep a waiting worker busy instead of blocking a thread the group's own
+    // tasks may need
+    if (_exec.workerIdx() != Executor::NOT_A_WORKER) _exec.helpUntil(finished);
+
+    std::unique_lock<std::mutex> lock(_lock);
+    _idle.wait(lock, finished);
+
+    if (_error) {
+        std::exception_ptr error = _error;
+        _error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
@@ -13,6 +13,7 @@
 #include <iostream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 #include "get.hpp"
 #include "key.hpp"
@@ -38,14 +39,22 @@ KVStore::KVStore(KVNet& kvNet, const char* address, const char* port)
 
 // Shuts down listener and destroys the KVStore
 KVStore::~KVStore() {
-    auto msg = std::make_shared<Kill>(_idx, _idx);
-    _kvNet.send(msg);
+    {
+        // Before registering there is no index to send the Kill to, the
+        // listener stops once the network shut down instead
+        const std::lock_guard<std::mutex> lock(_idxMutex);
+        if (_idx) {
+            _kvNet.send(std::make_shared<Kill>(_idx, _idx));
+        } else {
+            _kvNet.shutdown();
+        }
+    }
     _listener.join();
 }
 
 // Adds a DataFrame to the store at the key provided, assuming it does not
 // already exist
-void KVStore::insert(const Key& key, DFPtr value) {
+void KVStore::insert(const Key& key, const DFPtr& value) {
     std::shared_lock<std::shared_mutex> readLock(_storeMutex);
     // Currently ignores
     if (_store.count(key)) {
@@ -102,21 +111,38 @@ void KVStore::fetch(const Key& key, bool wait) {
 
 // Places a DataFrame at the given Key, either locally if Key matches current
 // index, or sends it remotely to its home
-void KVStore::push(const Key& key, DFPtr value) {
+void KVStore::push(const Key& key, const DFPtr& value,
+                   std::function<void()> done) {
     _readyGuard();
     if (key.home() == _idx) {
         insert(key, value);
+        if (done) done();
     } else {
-        _kvNet.send(std::make_shared<Put>(_idx, key, value));
+        auto msg = std::make_shared<Put>(_idx, key, value);
+        _kvNet.send(msg);
+        // Only once sent, so that a failed send leaves done to the caller.
+        // msg is still held here, so the Put can't have been released yet.
+        if (done) msg->onRelease(std::move(done));
     }
 }
 
-// Polling logic that processes received messages from the network
+size_t KVStore::idx() {
+    _readyGuard();
+    return _idx;
+}
+
+// Waits for messages from the network and processes them
 void KVStore::_listen(const char* address, const char* port) {
-    _idx = _kvNet.registerNode(address, port);
+    {
+        size_t idx = _kvNet.registerNode(address, port);
+        const std::lock_guard<std::mutex> lock(_idxMutex);
+        _idx = idx;
+    }
+    _registered.notify_all();
+
     bool listening = true;
     while (listening) {
-        std::shared_ptr<Message> msg = _kvNet.receive();
+        std::shared_ptr<Message> msg = _kvNet.waitAndReceive();
 
         // Temp
         std::shared_ptr<Put> putMsg;
@@ -160,7 +186,8 @@ void KVStore::_listen(const char* address, const char* port) {
                         << '\n';
             }
         } else {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            // The network shut down
+            listening = false;
         }
     }
 }
@@ -220,7 +247,8 @@ void KVStore::_startWaitAndGetReply(std::shared_ptr<WaitAndGet> msg) {
 // set. 0 is a reserved value for the registrar, so the new index must not be 0
 void KVStore::_readyGuard() {
     if (!_kvNet.ready()) throw std::runtime_error("Network is not ready");
-    while (_idx == 0) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    }
+    if (_idx) return;
+
+    std::unique_lock<std::mutex> lock(_idxMutex);
+    _registered.wait(lock, [this] { return _idx != 0; });
 }
\ No newline at end of file
@@ -13,18 +13,43 @@
 #include "fielder.hpp"
 #include "schema.hpp"
 
-Row::Row(Schema& scm) : _schema(scm), _idx(0), _data(scm.width()) {}
+Row::Row(Schema& scm)
+    : _schema(scm), _idx(0), _data(scm.width()), _missing(scm.width()) {}
 
 /** Setters: set the given column with the given value. Setting a column
  * with a value of the wrong type is undefined. */
-void Row::set(size_t col, int val) { _data[col] = val; }
+void Row::set(size_t col, int val) {
+    _data[col] = val;
+    _missing[col] = false;
+}
 
-void Row::set(size_t col, double val) { _data[col] = val; }
+void Row::set(size_t col, double val) {
+    _data[col] = val;
+    _missing[col] = false;
+}
 
-void Row::set(size_t col, bool val) { _data[col] = val; }
+void Row::set(size_t col, bool val) {
+    _data[col] = val;
+    _missing[col] = false;
+}
 
 // String is external
-void Row::set(size_t col, ExtString val) { _data[col] = val; }
+void Row::set(size_t col, ExtString val) {
+    _data[col] = val;
+    _missing[col] = false;
+}
+
+void Row::set(size_t col, std::string_view val) {
+    _data[col] = val;
+    _missing[col] = false;
+}
+
+/** Marks the given field as missing, setting a value makes it present
+ * again. */
+void Row::setMissing(size_t col) { _missing.at(col) = true; }
+
+/** Whether the given field is missing. */
+bool Row::isMissing(size_t col) { return _missing.at(col); }
 
 /** Set/get the index of this row (ie. its position in the dataframe. This
  * is only used for informational purposes, unused otherwise */
@@ -44,8 +69,11 @@ size_t Row::getIdx() { return _idx; }
 int Row::getInt(size_t col) { return std::get<int>(_data.at(col)); }
 bool Row::getBool(size_t col) { return std::get<bool>(_data.at(col)); }
 double Row::getDouble(size_t col) { return std::get<double>(_data.at(col)); }
-ExtString Row::getString(size_t col) {
-    return std::get<ExtString>(_data.at(col));
+std::string_view Row::getString(size_t col) {
+    if (auto owned = std::get_if<ExtString>(&_data.at(col))) {
+        return *owned ? std::string_view(**owned) : std::string_view();
+    }
+    return std::get<std::string_view>(_data.at(col));
 }
 
 /** Number of fields in the row. */
@@ -68,6 +96,11 @@ void Row::visit(size_t idx, Fielder& f) {
     f.start(idx);
 
     for (size_t ii = 0; ii < _data.size(); ii++) {
+        if (_missing[ii]) {
+            f.acceptMissing();
+            continue;
+        }
+
         // todo use std::visit maybe
         char type = col_type(ii);
 
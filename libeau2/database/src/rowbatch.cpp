@@ -0,0 +1,99 @@
+/**
+ * @file rowbatch.cpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#include "rowbatch.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include "chunk.hpp"
+#include "column.hpp"
+#include "dataframe.hpp"
+#include "schema.hpp"
+
+RowBatch::RowBatch(DataFrame& df, size_t start, size_t size)
+    : _df(df),
+      _start(start),
+      _size(size),
+      _selected(size, 0),
+      _row(df.getSchema()) {}
+
+size_t RowBatch::start() const { return _start; }
+
+size_t RowBatch::size() const { return _size; }
+
+Block<uint32_t> RowBatch::codes(size_t col) {
+    const Column<ExtString>& strings = _df.column<ExtString>(col).column();
+    if (!strings.dict())
+        throw std::runtime_error("Column is not dictionary encoded");
+
+    return strings.codes().slice(_start, _size);
+}
+
+// Batches start on a multiple of 64 rows, so they start on a whole word
+Block<uint64_t> RowBatch::bits(size_t col) {
+    const Bitmap& bits = _df.column<bool>(col).column().bits();
+    size_t word = _start / Bitmap::WORD_BITS;
+
+    return Block<uint64_t>(bits.words() + word,
+                           (_size + Bitmap::WORD_BITS - 1) / Bitmap::WORD_BITS);
+}
+
+uint8_t* RowBatch::selected() { return _selected.data(); }
+
+void RowBatch::select(size_t idx, bool keep) { _selected[idx] = keep; }
+
+bool RowBatch::isSelected(size_t idx) const { return _selected[idx]; }
+
+size_t RowBatch::selectedCount() const {
+    return std::accumulate(_selected.begin(), _selected.end(), size_t(0));
+}
+
+Bitmap RowBatch::selection() const {
+    Bitmap bits(_size);
+    uint64_t* words = bits.words();
+
+    for (size_t ii = 0; ii < _size; ii++) {
+        words[ii / 64] |= uint64_t(_selected[ii] != 0) << (ii % 64);
+    }
+
+    return bits;
+}
+
+Row& RowBatch::row(size_t idx) {
+    _df.fillRow(_start + idx, _row);
+    return _row;
+}
+
+// Chunk sizes are all powers of two, so the smallest one divides the others
+// and a batch aligned to it lies within a single chunk of every column. Bool
+// columns are a single Bitmap and only need batches to be whole words.
+size_t RowBatch::maxSize(const Schema& schema) {
+    size_t batchSize = CHUNK_BYTES;
+
+    for (size_t ii = 0; ii < schema.width(); ii++) {
+        switch (schema.colType(ii)) {
+            case 'I':
+                batchSize = std::min(batchSize, Chunk<int>::size());
+                break;
+            case 'B':
+                break;
+            case 'D':
+                batchSize = std::min(batchSize, Chunk<double>::size());
+                break;
+            case 'S':  // strings are chunked by their arena offsets
+                batchSize = std::min(batchSize, Chunk<uint64_t>::size());
+                break;
+            default:
+                batchSize = std::min(batchSize, Chunk<int64_t>::size());
+        }
+    }
+
+    return batchSize;
+}
@@ -0,0 +1,18 @@
+/**
+ * @file rower.cpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#include "rower.hpp"
+
+#include "rowbatch.hpp"
+
+// Falls back to visiting the rows of the batch one at a time
+void Rower::acceptBatch(RowBatch& batch) {
+    for (size_t ii = 0; ii < batch.size(); ii++) {
+        batch.select(ii, accept(batch.row(ii)));
+    }
+}
@@ -10,11 +10,13 @@
 
 #include <iostream>
 #include <memory>
+#include <stdexcept>
 
 Schema::Schema(const Schema& from)
     : _rowNames(from._rowNames),
       _colNames(from._colNames),
       _colTypes(from._colTypes),
+      _nullable(from._nullable),
       _local(from._local),
       _length(from._length) {}
 
@@ -27,7 +29,7 @@ Schema::Schema(const char* types, bool local) : _local(local) {
     }
 }
 
-bool Schema::addCol(const char type, ExtString name) {
+bool Schema::addCol(const char type, ExtString name, bool nullable) {
     switch (type) {
         case 'S':
         case 'B':
@@ -37,6 +39,7 @@ bool Schema::addCol(const char type, ExtString name) {
         case 'F':
             _colTypes.push_back(type);
             _colNames.push_back(name);
+            _nullable.push_back(nullable);
             return true;
         default:
             std::cerr << "Unknown column type '" << type << "'" << std::endl;
@@ -48,6 +51,12 @@ bool Schema::addCol(const char type, ExtString name) {
  * are expectd to be unique, duplicates result in undefined behavior. */
 void Schema::addRow(ExtString name) { _rowNames.push_back(name); }
 
+/** Removes every row, keeping the columns. */
+void Schema::clearRows() {
+    _rowNames.clear();
+    _length = 0;
+}
+
 /** Return name of row at idx; nullptr indicates no name. An idx >=
  * width is undefined. */
 std::string Schema::rowName(size_t idx) const { return *_rowNames.at(idx); }
@@ -78,6 +87,15 @@ Serial::Type Schema::colSerialType(size_t idx) const {
     }
 }
 
+/** Whether the column at idx may have missing values. An idx >= width is
+ * undefined. */
+bool Schema::isNullable(size_t idx) const { return _nullable.at(idx); }
+
+/** Marks whether the column at idx may have missing values. */
+void Schema::setNullable(size_t idx, bool nullable) {
+    _nullable.at(idx) = nullable;
+}
+
 /** Given a column name return its index, or -1. */
 int Schema::colIdx(const char* name) const {
     for (size_t ii = 0; ii < _colNames.size(); ii++) {
@@ -112,4 +130,10 @@ size_t Schema::length() const {
     }
 }
 
+/** Sets the total number of rows of a remote Schema. */
+void Schema::setLength(size_t length) {
+    if (_local) throw std::invalid_argument("Local Schema length is its rows");
+    _length = length;
+}
+
 bool Schema::isLocal() const { return _local; }
\ No newline at end of file
@@ -0,0 +1,62 @@
+/**
+ * @file slab.cpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#include "slab.hpp"
+
+#include <new>
+#include <stdexcept>
+
+namespace {
+constexpr size_t MAX_REGION_BLOCKS =
+    16;  // Upper bound on blocks per region, limits over-allocation
+}  // namespace
+
+Slab::Slab(size_t blockSize, size_t alignment)
+    : _blockSize(blockSize), _alignment(alignment) {
+    if (!blockSize || blockSize % alignment)
+        throw std::invalid_argument(
+            "Block size must be a multiple of alignment");
+}
+
+Slab::~Slab() { clear(); }
+
+// Returns a new uninitialized block of blockSize() bytes
+void* Slab::allocate() {
+    if (!_blocksLeft) _grow();
+
+    void* block = _next;
+    _next += _blockSize;
+    _blocksLeft--;
+
+    return block;
+}
+
+size_t Slab::blockSize() const { return _blockSize; }
+
+// Regions start small again afterwards
+void Slab::clear() {
+    for (void* region : _regions) {
+        ::operator delete(region, std::align_val_t(_alignment));
+    }
+    _regions.clear();
+    _next = nullptr;
+    _blocksLeft = 0;
+    _nextRegionBlocks = 1;
+}
+
+// Regions double in size until they reach MAX_REGION_BLOCKS blocks
+void Slab::_grow() {
+    void* region = ::operator new(_nextRegionBlocks * _blockSize,
+                                  std::align_val_t(_alignment));
+    _regions.push_back(region);
+
+    _next = static_cast<uint8_t*>(region);
+    _blocksLeft = _nextRegionBlocks;
+
+    if (_nextRegionBlocks < MAX_REGION_BLOCKS) _nextRegionBlocks *= 2;
+}
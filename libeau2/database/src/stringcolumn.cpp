@@ -0,0 +1,218 @@
+/**
+ * @file stringcolumn.cpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "column.hpp"
+#include "payload.hpp"
+
+size_t Column<ExtString>::ArenaHash::operator()(uint64_t offset) const {
+    return std::hash<std::string_view>()(arena->data() + offset);
+}
+
+bool Column<ExtString>::ArenaEqual::operator()(uint64_t a, uint64_t b) const {
+    return strcmp(arena->data() + a, arena->data() + b) == 0;
+}
+
+Column<ExtString>::Column(bool intern) {
+    if (intern) {
+        _interned = std::make_unique<InternSet>(0, ArenaHash{&_arena},
+                                                ArenaEqual{&_arena});
+    }
+}
+
+Column<ExtString>::Column(std::shared_ptr<StringDict> dict)
+    : _dict(std::move(dict)) {
+    if (!_dict) throw std::invalid_argument("Dictionary cannot be null");
+}
+
+Column<ExtString>::Column(std::initializer_list<ExtString> ll) : Column() {
+    for (const ExtString& e : ll) push_back(e);
+}
+
+Column<ExtString>::Column(std::shared_ptr<void> backing, const char* arena,
+                          size_t arenaBytes, void* offsets, size_t size)
+    : _arena(arena, arena + arenaBytes),
+      _offsets(std::move(backing), offsets, size) {
+    _validity.resize(size);
+}
+
+// The string is appended first so the set can look it up by offset; a
+// duplicate is then dropped from the arena again
+uint64_t Column<ExtString>::_store(std::string_view val) {
+    uint64_t offset = _arena.size();
+    _arena.insert(_arena.end(), val.begin(), val.end());
+    _arena.push_back('\0');
+
+    if (_interned) {
+        auto found = _interned->insert(offset);
+        if (!found.second) {
+            _arena.resize(offset);
+            _dense = false;
+            return *found.first;
+        }
+    }
+
+    return offset;
+}
+
+std::string_view Column<ExtString>::get(size_t idx) const {
+    if (_dict) return _dict->str(_codes.get(idx));
+    return _arena.data() + _offsets.get(idx);
+}
+
+void Column<ExtString>::set(size_t idx, ExtString val) {
+    set(idx, val ? std::string_view(*val) : std::string_view());
+}
+
+// The old value is left behind in the arena
+void Column<ExtString>::set(size_t idx, std::string_view val) {
+    _validity.set(idx, true);
+    if (_dict) return _codes.set(idx, _dict->add(val));
+
+    _offsets.set(idx, _store(val));
+    _dense = false;
+}
+
+void Column<ExtString>::push_back(ExtString val) {
+    push_back(val ? std::string_view(*val) : std::string_view());
+}
+
+void Column<ExtString>::push_back(std::string_view val) {
+    _validity.push_back(true);
+    if (_dict) return _codes.push_back(_dict->add(val));
+
+    _offsets.push_back(_store(val));
+}
+
+// Missing items hold an empty string
+void Column<ExtString>::pushMissing() {
+    push_back(std::string_view());
+    _validity.set(size() - 1, false);
+}
+
+void Column<ExtString>::pushPacked(const char* strings, size_t size) {
+    while (size && strings[size - 1] != '\0') size--;
+
+    if (_interned || _dict) {
+        for (const char* str = strings; str < strings + size;
+             str += strlen(str) + 1) {
+            push_back(std::string_view(str));
+        }
+        return;
+    }
+
+    uint64_t base = _arena.size();
+    _arena.insert(_arena.end(), strings, strings + size);
+
+    // each string starts right after the previous NUL
+    uint64_t start = base;
+    for (uint64_t ii = base; ii < _arena.size(); ii++) {
+        if (_arena[ii] == '\0') {
+            _offsets.push_back(start);
+            _validity.push_back(true);
+            start = ii + 1;
+        }
+    }
+}
+
+bool Column<ExtString>::interned() const { return _interned != nullptr; }
+
+const std::shared_ptr<StringDict>& Column<ExtString>::dict() const {
+    return _dict;
+}
+
+uint32_t Column<ExtString>::code(size_t idx) const { return _codes.get(idx); }
+
+const Column<uint32_t>& Column<ExtString>::codes() const { return _codes; }
+
+void Column<ExtString>::pushCode(uint32_t code) {
+    _codes.push_back(code);
+    _validity.push_back(true);
+}
+
+size_t Column<ExtString>::arenaBytes() const { return _arena.size(); }
+
+size_t Column<ExtString>::size() const {
+    return _dict ? _codes.size() : _offsets.size();
+}
+
+std::string Column<ExtString>::str() const {
+    std::stringstream ss;
+
+    for (size_t i = 0; i < size(); i++) {
+        ss << get(i);
+        if (i != size() - 1) {
+            ss << ", ";
+        }
+    }
+
+    return ss.str();
+}
+
+void Column<ExtString>::serialize(Serializer& ss) const {
+    std::vector<const StringDict*> sentDicts;
+    serialize(ss, sentDicts);
+}
+
+// A dense arena is already in Payload format and is copied in one go.
+// Encoded columns are sent as the dictionary's index among those of the
+// DataFrame, the size of the packed dictionary and its strings in code order
+// if it was not sent yet, then the codes.
+void Column<ExtString>::serialize(
+    Serializer& ss, std::vector<const StringDict*>& sentDicts) const {
+    Payload colData;
+
+    if (_dict) {
+        auto sent = std::find(sentDicts.begin(), sentDicts.end(), _dict.get());
+        uint64_t dictIdx = sent - sentDicts.begin();
+        colData.addBytes(Serial::Type::DictString, &dictIdx, sizeof(dictIdx));
+
+        if (sent == sentDicts.end()) {
+            sentDicts.push_back(_dict.get());
+
+            std::vector<char> packed;
+            for (uint32_t code = 0; code < _dict->size(); code++) {
+                std::string_view val = _dict->str(code);
+                packed.insert(packed.end(), val.begin(), val.end());
+                packed.push_back('\0');
+            }
+
+            uint64_t dictBytes = packed.size();
+            colData.addBytes(Serial::Type::DictString, &dictBytes,
+                             sizeof(dictBytes));
+            colData.addBytes(Serial::Type::DictString, packed.data(),
+                             packed.size());
+        }
+        for (size_t ii = 0; ii < _codes.blocks(); ii++) {
+            Block<uint32_t> block = _codes.block(ii);
+            colData.addBytes(Serial::Type::DictString, block.data(),
+                             block.size() * sizeof(uint32_t));
+        }
+    } else if (_dense) {
+        colData.addStrings(_arena.data(), _arena.size());
+    } else {
+        std::vector<char> packed;
+        for (size_t ii = 0; ii < size(); ii++) {
+            std::string_view val = get(ii);
+            packed.insert(packed.end(), val.begin(), val.end());
+            packed.push_back('\0');
+        }
+        colData.addStrings(packed.data(), packed.size());
+    }
+
+    colData.serialize(ss);
+}
+
+bool Column<ExtString>::canSerialize() const { return size() != 0; }
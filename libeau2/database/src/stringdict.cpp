@@ -0,0 +1,38 @@
+/**
+ * @file stringdict.cpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#include "stringdict.hpp"
+
+#include <stdexcept>
+
+StringDict::StringDict() {}
+
+uint32_t StringDict::add(std::string_view str) {
+    auto found = _codes.find(str);
+    if (found != _codes.end()) return found->second;
+
+    if (_strings.size() >= NOT_FOUND)
+        throw std::overflow_error("Too many strings in dictionary");
+
+    uint32_t code = _strings.size();
+    _strings.emplace_back(str);
+    _codes.emplace(_strings.back(), code);
+
+    return code;
+}
+
+uint32_t StringDict::find(std::string_view str) const {
+    auto found = _codes.find(str);
+    return found == _codes.end() ? NOT_FOUND : found->second;
+}
+
+std::string_view StringDict::str(uint32_t code) const {
+    return _strings[code];
+}
+
+size_t StringDict::size() const { return _strings.size(); }
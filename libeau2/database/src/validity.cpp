@@ -0,0 +1,109 @@
+/**
+ * @file validity.cpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#include "validity.hpp"
+
+#include <algorithm>
+#include <utility>
+
+Validity::Validity() {}
+
+bool Validity::isMissing(size_t idx) const {
+    return _present && !_present->get(idx);
+}
+
+void Validity::push_back(bool present) {
+    if (!_present) {
+        if (present) {
+            _size++;
+            return;
+        }
+        _present = std::make_unique<Bitmap>(_size, true);
+    }
+
+    _present->push_back(present);
+    if (!present) _countNull(_size, 1);
+    _size++;
+}
+
+void Validity::set(size_t idx, bool present) {
+    if (!_present) {
+        if (present) return;
+        _present = std::make_unique<Bitmap>(_size, true);
+    }
+
+    if (_present->get(idx) == present) return;
+
+    _present->set(idx, present);
+    _countNull(idx, present ? -1 : 1);
+}
+
+void Validity::resize(size_t size) {
+    _size = size;
+
+    if (_present) {
+        _present->resize(size, true);
+        _recount();
+    }
+}
+
+size_t Validity::nullCount() const { return _nulls; }
+
+bool Validity::anyMissing(size_t start, size_t len) const {
+    if (!_nulls || !len) return false;
+
+    size_t last = std::min((start + len - 1) / CHUNK_ITEMS + 1,
+                           _chunkNulls.size());
+    for (size_t chunk = start / CHUNK_ITEMS; chunk < last; chunk++) {
+        if (_chunkNulls[chunk]) return true;
+    }
+
+    return false;
+}
+
+const Bitmap* Validity::present() const { return _present.get(); }
+
+void Validity::assign(Bitmap present) {
+    _size = present.size();
+    _present = std::make_unique<Bitmap>(std::move(present));
+    _recount();
+
+    if (!_nulls) _present.reset();
+}
+
+void Validity::_countNull(size_t idx, int delta) {
+    size_t chunk = idx / CHUNK_ITEMS;
+    if (chunk >= _chunkNulls.size()) _chunkNulls.resize(chunk + 1, 0);
+
+    _chunkNulls[chunk] += delta;
+    _nulls += delta;
+}
+
+// Counts the clear bits of each chunk's words, the bits past the end are
+// always clear and are not counted
+void Validity::_recount() {
+    constexpr size_t CHUNK_WORDS = CHUNK_ITEMS / Bitmap::WORD_BITS;
+    const uint64_t* words = _present->words();
+
+    _chunkNulls.assign((_size + CHUNK_ITEMS - 1) / CHUNK_ITEMS, 0);
+    _nulls = 0;
+
+    for (size_t chunk = 0; chunk < _chunkNulls.size(); chunk++) {
+        size_t first = chunk * CHUNK_ITEMS;
+        size_t items = std::min(CHUNK_ITEMS, _size - first);
+        size_t set = 0;
+
+        size_t end = std::min(_present->wordCount(), (chunk + 1) * CHUNK_WORDS);
+        for (size_t word = chunk * CHUNK_WORDS; word < end; word++) {
+            set += __builtin_popcountll(words[word]);
+        }
+
+        _chunkNulls[chunk] = items - set;
+        _nulls += items - set;
+    }
+}
@@ -0,0 +1,77 @@
+/**
+ * @file frame.hpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "serial.hpp"
+
+// Header in front of every frame sent between nodes. Messages are split into
+// frames so that small messages are not held up behind large ones, and so
+// that the frames of one message can be spread over several connections.
+struct FrameHeader {
+    uint64_t sender;  // node the message came from
+    uint64_t stream;  // tells the messages its sender has in flight apart
+    uint64_t total;   // length of the whole message
+    uint64_t offset;  // where the frame's bytes go in the message
+    uint64_t length;  // bytes following the header
+};
+
+// The frames of one message, pushed in any order as they arrive and read
+// back in order by a thread deserializing the message. Frames are kept until
+// that thread gets to them, so pushing never waits for it.
+class FrameStream {
+   private:
+    std::mutex _lock;
+    std::condition_variable _cv;  // signaled as frames arrive or reads stop
+    std::map<uint64_t, std::vector<uint8_t>> _frames;  // unread, by offset
+    uint64_t _total;          // length of the message
+    uint64_t _offset = 0;     // bytes read so far
+    uint64_t _received = 0;   // bytes pushed so far
+    uint64_t _buffered = 0;   // bytes of _frames
+    bool _detached = false;   // whether the thread reading stopped reading
+    bool _closed = false;     // whether reads give up once out of frames
+
+   public:
+    explicit FrameStream(uint64_t total);
+
+    // Length of the message
+    uint64_t total() const;
+
+    // Whether every frame has been pushed
+    bool complete();
+
+    // Bytes of the frames kept that have not been entirely read
+    uint64_t buffered();
+
+    // Adds the frame of the given length at the given offset, whose bytes
+    // are read with read. The frame is kept for read(), or skipped once
+    // nobody reads the message. Returns 0, or a negative errno if read fails.
+    ssize_t push(uint64_t offset, uint64_t length, const Serial::Reader& read);
+
+    // Called by the thread reading the message once it stops reading, frames
+    // kept or pushed later are dropped
+    void detach();
+
+    // Makes reads waiting for frames that did not arrive fail, and frames
+    // pushed later are skipped
+    void close();
+
+    // Reads exactly bytes bytes of the message in order, waiting for their
+    // frames to arrive. Returns 0, or a negative errno on failure. Serves as
+    // a Serial::Reader.
+    ssize_t read(void* buf, size_t bytes);
+};
@@ -32,11 +32,20 @@ class KVNet {
     virtual void send(std::shared_ptr<Message> msg) = 0;
 
     /**
-     * @brief Receive a message on this node from the queue.
+     * @brief Receive a message on this node from the queue. The message may
+     * be the one sent, if it didn't need to be copied to get here.
      *
-     * @return std::unique_ptr<Message> the message
+     * @return std::shared_ptr<Message> the message
      */
-    virtual std::unique_ptr<Message> receive() = 0;
+    virtual std::shared_ptr<Message> receive() = 0;
+
+    /**
+     * @brief Waits for a message on this node, rather than polling receive().
+     *
+     * @return std::shared_ptr<Message> the message, nullptr once the network
+     * shut down and no messages are left
+     */
+    virtual std::shared_ptr<Message> waitAndReceive() = 0;
 
     /**
      * @brief Checks if the network is ready, if not waits a predetermined delay
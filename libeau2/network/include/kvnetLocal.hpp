@@ -0,0 +1,82 @@
+/**
+ * @file kvnetLocal.hpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+#include "kvnet.hpp"
+
+class Message;
+
+/**
+ * @brief Connects nodes that are threads of the same process. Messages are
+ * handed to their target as they are, without being serialized, so the
+ * target shares the DataFrames they carry with the sender.
+ */
+class KVNetLocal : public KVNet {
+   public:
+    // The nodes of one process, which every one of their KVNetLocals shares
+    class Cluster {
+       private:
+        friend class KVNetLocal;
+
+        std::mutex _lock;                  // guards _nodes
+        std::condition_variable _changed;  // notified as nodes register or
+                                           // shut down
+        size_t _size;                      // number of nodes expected
+        std::vector<KVNetLocal*> _nodes;  // by node index, nullptr for the
+                                          // registrar and nodes gone
+
+       public:
+        // The network is up once the given number of nodes registered
+        explicit Cluster(size_t nodes);
+    };
+
+   private:
+    Cluster& _cluster;  // the nodes messages can be sent to
+    uint64_t _idx = 0;  // the index of this node, set by registerNode()
+    bool _up = false;   // whether this node registered and hasn't shut down,
+                        // guarded by the cluster's lock
+    std::queue<std::shared_ptr<Message>>
+        _receiving;                     // messages handed to this node
+    std::mutex _receiveLock;            // receiving queue lock
+    std::condition_variable _received;  // notified as messages are handed
+                                        // to this node
+    bool _stopped = false;  // set by shutdown(), guarded by _receiveLock
+
+    // Queues a message sent to this node
+    void _deliver(std::shared_ptr<Message> msg);
+
+   public:
+    explicit KVNetLocal(Cluster& cluster);
+    virtual ~KVNetLocal();
+
+    // Joins the cluster, the address and port are not used
+    size_t registerNode(const char* address, const char* port) override;
+
+    // Hands the message to its target
+    void send(std::shared_ptr<Message> msg) override;
+
+    // Pops a message handed to this node, if any
+    std::shared_ptr<Message> receive() override;
+
+    // Waits for a message to be handed to this node
+    std::shared_ptr<Message> waitAndReceive() override;
+
+    // Waits for every node of the cluster to register
+    bool ready() override;
+
+    void shutdown() override;
+};
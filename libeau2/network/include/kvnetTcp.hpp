@@ -15,58 +15,162 @@
 #include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <string>
 #include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "frame.hpp"
 #include "kvnet.hpp"
+#include "serial.hpp"
+#include "shmring.hpp"
 
 class Message;
 
 class KVNetTCP : public KVNet {
    private:
+    struct Outgoing;  // a Message being sent, see kvnetTcp.cpp
+    struct Frame;     // a frame of an Outgoing being written
+
+    // One of the connections to a Peer
+    struct Conn {
+        int sock = -1;                 // non-blocking socket to the node
+        bool connected = false;        // whether connect() has finished
+        bool watched = false;          // whether epoll waits for it
+        std::unique_ptr<Frame> frame;  // being written, if any
+    };
+
+    // A node messages are sent to, only used by the sender thread
+    struct Peer {
+        bool framed = true;       // false for the registrar, which reads
+                                  // whole messages
+        std::vector<Conn> conns;  // frames go out on whichever is free
+        std::deque<std::shared_ptr<Outgoing>>
+            queue;  // messages with frames left, taking turns a frame each
+    };
+
+    // A node on the same host, sent to through its shared memory ring
+    struct ShmLink {
+        std::string name;               // name of the node's ring
+        std::unique_ptr<ShmRing> ring;  // opened once the node created it
+        std::queue<std::shared_ptr<Message>> queue;  // messages to write
+        std::mutex lock;                 // queue and ring lock
+        std::condition_variable queued;  // notified when queue grows
+        std::thread writer;              // writes queued messages to ring
+        bool broken = false;  // set once writing failed, then sent over TCP
+    };
+
+    std::queue<std::shared_ptr<Message>>
+        _sending;  // queue for messages to send, handed to the sender thread
     std::queue<std::shared_ptr<Message>>
-        _sending;  // queue for messages to send, monitored by sender thread
-    std::queue<std::unique_ptr<Message>>
         _receiving;        // queue for messages received, populated by receiver
                            // thread and processed by listener in KVStore
     std::mutex _sendLock;  // sending queue lock
-    std::mutex _receiveLock;          // receiving queue lock
+    std::mutex _receiveLock;            // receiving queue lock
+    std::condition_variable _received;  // notified as messages are received
+    bool _stopped = false;  // set by shutdown(), guarded by _receiveLock
     std::atomic_bool _netUp = false;  // is the network currently connected?
-    std::thread _senderThread;        // sends pending messages
-    std::thread _receiverThread;      // receives pending messages
+    bool _wasUp = false;  // whether the network was ever up, guarded by
+                          // _upLock
+    std::mutex _upLock;                  // network status lock
+    std::condition_variable _upChanged;  // notified when the network is up
+    std::thread _senderThread;    // sends pending messages
+    std::thread _receiverThread;  // receives pending messages
     std::unordered_map<uint64_t, uint16_t>
         _sendSocks;  // map of connections from node index to socket
     uint64_t _idx =
         0;  // the index of this KVStore, populated by registerNode()
     std::vector<struct sockaddr_in>
         _dir;  // directory indexed by node to address and port
-    std::condition_variable
-        _senderCv;  // Wakes up the sender when messages are available to send
+    int _wakeFd = -1;  // eventfd that wakes the sender when messages are
+                       // queued
+    size_t _connections;  // connections opened to each node
+    uint64_t _nextStream = 0;  // stream of the next message sent over TCP,
+                               // only used by the sender thread
+    std::map<std::pair<uint64_t, uint64_t>, std::shared_ptr<FrameStream>>
+        _streams;  // messages split over frames still arriving, by sender
+                   // and stream, only used by the receiver thread
+    std::deque<std::shared_ptr<FrameStream>>
+        _undecoded;  // messages of _streams waiting for a decoder
+    std::mutex _decodeLock;                 // undecoded queue lock
+    std::condition_variable _decodeQueued;  // notified when _undecoded grows
+    std::vector<std::thread> _decoders;     // deserialize the messages of
+                                            // _streams as they arrive, only
+                                            // added to by the receiver once
+                                            // the network is up
+    size_t _idleDecoders = 0;  // decoders waiting for a message, guarded by
+                               // _decodeLock
+    bool _sharedMemory;  // whether nodes on this host are sent to through
+                         // shared memory
+    std::unordered_map<uint64_t, std::unique_ptr<ShmLink>>
+        _shmLinks;  // nodes on this host by node index
+    std::vector<std::unique_ptr<ShmRing>>
+        _shmRings;  // rings nodes on this host write to this node through
+    std::vector<std::thread> _shmReaders;  // one per ring in _shmRings
 
     // Reads an entire Message from the socket specified
     std::unique_ptr<Message> _readMsg(int sock);
 
     // Read a specific serial format
     ssize_t _readPayload(int sock, std::vector<uint8_t>& msg);
-    ssize_t _readPut(int sock, std::vector<uint8_t>& msg);
-    ssize_t _readReply(int sock, std::vector<uint8_t>& msg);
     ssize_t _readGet(int sock, std::vector<uint8_t>& msg);
     ssize_t _readWaitAndGet(int sock, std::vector<uint8_t>& msg);
     ssize_t _readDirectory(int sock, std::vector<uint8_t>& msg);
 
-    // Sender logic
+    // Reads a frame from the socket specified, see FrameHeader
+    ssize_t _readFrame(int sock);
+    // Keeps the frames of messages waiting for a decoder within bounds, once
+    // a frame of the given stream from sender was pushed
+    void _limitWaiting(uint64_t sender,
+                       const std::shared_ptr<FrameStream>& stream);
+    // Decoder logic, takes turns deserializing the messages of _undecoded
+    void _decoder();
+    // Deserializes a message split over frames as they arrive
+    void _decode(std::shared_ptr<FrameStream> stream);
+    // Reads a message of total bytes, nullptr if invalid
+    std::unique_ptr<Message> _readWhole(const Serial::Reader& read,
+                                        uint64_t total);
+    // Queues a message received for this node
+    void _deliver(std::shared_ptr<Message> msg);
+
+    // Queues a message for the sender thread and wakes it
+    void _sendTcp(std::shared_ptr<Message> msg);
+    // Sender logic, writes to every Peer without blocking
     void _sender();
+    // Starts a non-blocking connection to the node at target
+    void _connect(uint64_t target, Conn& conn);
+    // Sends frames of a Peer's queued messages on one of its connections
+    // until they are all sent or the socket is full
+    void _flush(uint64_t target, Peer& peer, Conn& conn);
+    // Waits for a connection to be writable while it has frames to send
+    void _watch(int epollfd, const Peer& peer, Conn& conn);
     // Receiver logic
     void _receiver(const char* port);
 
+    // Name of the ring messages from one address to another go through
+    static std::string _shmName(const struct sockaddr_in& from,
+                                const struct sockaddr_in& to);
+    // Sets up rings to and from the nodes in the directory on this host
+    void _openShm();
+    // Writes the messages queued for a node on this host to its ring
+    void _shmWriter(uint64_t target, ShmLink& link);
+    // Reads messages from a node on this host until the ring is closed
+    void _shmReader(ShmRing& ring);
+
     bool _inDirectory(in_addr_t address);
 
    public:
-    KVNetTCP();
+    // Messages to each node are striped over the given number of
+    // connections, or go through shared memory if the node is on the same
+    // host and sharedMemory is set. A ring carries whole messages in order,
+    // so a small message waits behind a large one; TCP interleaves frames.
+    explicit KVNetTCP(size_t connections = 1, bool sharedMemory = false);
     virtual ~KVNetTCP();
 
     // Registers this node with the registrar using the port provided
@@ -76,7 +180,10 @@ class KVNetTCP : public KVNet {
     void send(std::shared_ptr<Message> msg) override;
 
     // Pops a received message if possible for processing
-    std::unique_ptr<Message> receive() override;
+    std::shared_ptr<Message> receive() override;
+
+    // Waits for a received message
+    std::shared_ptr<Message> waitAndReceive() override;
 
     bool ready() override;
 
@@ -0,0 +1,95 @@
+/**
+ * @file shmring.hpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "serializer.hpp"
+
+/**
+ * @brief A ring buffer of bytes in POSIX shared memory, written by one
+ * process and read by another on the same host. The reading side creates the
+ * ring, the writing side opens it by name once the reader acknowledges it,
+ * so that a ring left behind by a run that crashed is never written to. Both
+ * block while the ring is full or empty, waking each other through a process
+ * shared condition variable.
+ */
+class ShmRing {
+   private:
+    struct Header;  // layout of the start of the segment
+
+    std::string _name;               // name of the segment
+    Header* _header = nullptr;       // start of the mapped segment
+    uint8_t* _data = nullptr;        // the ring, after the header
+    size_t _mapBytes = 0;            // length of the mapping
+    bool _owner = false;             // whether this side created the ring
+    std::atomic_bool _closed = false;  // whether this side closed the ring
+
+    ShmRing(const std::string& name, void* map, size_t mapBytes, bool owner);
+
+    // Locks the ring. If a process died holding the lock the ring is closed,
+    // as whatever it was doing was left half done.
+    static void _lock(Header* header);
+    static void _recover(Header* header);
+
+    // Waits under the ring's lock until pred() holds or the ring is closed,
+    // acknowledging writers that open the ring meanwhile if this side created
+    // it. Returns whether pred() holds and this side is still open.
+    template <typename P>
+    bool _wait(P pred);
+
+   public:
+    // Capacity of rings created without one
+    static constexpr size_t DEFAULT_BYTES = 16 << 20;
+
+    /**
+     * @brief Creates the named ring, replacing any left by an earlier run.
+     *
+     * @param name      name of the segment, starting with '/'
+     * @param capacity  bytes the ring holds
+     * @return std::unique_ptr<ShmRing> nullptr on failure
+     */
+    static std::unique_ptr<ShmRing> create(const std::string& name,
+                                           size_t capacity = DEFAULT_BYTES);
+
+    /**
+     * @brief Opens a ring another process created, waiting for it to
+     * acknowledge the writer from a read.
+     *
+     * @param name
+     * @return std::unique_ptr<ShmRing> nullptr if it does not exist, is not
+     * set up yet, or nobody reads it
+     */
+    static std::unique_ptr<ShmRing> open(const std::string& name);
+
+    // Unmaps the ring, the side that created it also removes it
+    ~ShmRing();
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    // Writes the pieces in order, waiting for room. Returns 0, or a negative
+    // errno once either side closed the ring.
+    ssize_t write(const std::vector<Serializer::Piece>& pieces);
+
+    // Reads exactly bytes bytes, waiting for them. Returns 0, or a negative
+    // errno once this side closed the ring, or the other side did and the
+    // ring is empty. Serves as a Serial::Reader.
+    ssize_t read(void* buf, size_t bytes);
+
+    // Makes waiting reads and writes fail on both sides
+    void close();
+};
@@ -11,11 +11,18 @@
 #include <netdb.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <climits>
 #include <cstring>
 #include <exception>
 #include <iostream>
+#include <vector>
+
+#include "serializer.hpp"
 
 // Utility functions for interacting with sockets interface over TCP
 namespace TCP {
@@ -112,7 +119,66 @@ inline ssize_t sendPacket(int socket,
     return sent == -1 ? -errno : 0;
 }
 
-// Receive an entire block of data
+// The pieces of a serialized Message still to be sent, handed to sendmsg as
+// an iovec rather than copied into one buffer first
+class PendingSend {
+   private:
+    std::vector<struct iovec> _iov;
+    size_t _next = 0;  // first iovec not entirely sent
+
+   public:
+    PendingSend() {}
+
+    explicit PendingSend(const std::vector<Serializer::Piece>& pieces)
+        : _iov(pieces.size()) {
+        for (size_t ii = 0; ii < pieces.size(); ii++) {
+            _iov[ii].iov_base = const_cast<uint8_t*>(pieces[ii].data);
+            _iov[ii].iov_len = pieces[ii].size;
+        }
+    }
+
+    // Whether every piece was sent
+    bool done() const { return _next == _iov.size(); }
+
+    // Sends until done or, with MSG_DONTWAIT, until the socket is full.
+    // Returns a negative errno if the socket failed.
+    ssize_t send(int socket, int flags = 0) {
+        while (!done()) {
+            struct msghdr msg = {};
+            msg.msg_iov = _iov.data() + _next;
+            msg.msg_iovlen = std::min<size_t>(_iov.size() - _next, IOV_MAX);
+
+            ssize_t sent = sendmsg(socket, &msg, flags);
+            if (sent == -1) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+                return -errno;
+            }
+
+            // Skip what was sent, the last iovec may have been sent in part
+            size_t left = sent;
+            while (_next < _iov.size() && left >= _iov[_next].iov_len) {
+                left -= _iov[_next++].iov_len;
+            }
+            if (left) {
+                uint8_t* base = static_cast<uint8_t*>(_iov[_next].iov_base);
+                _iov[_next].iov_base = base + left;
+                _iov[_next].iov_len -= left;
+            }
+        }
+
+        return 0;
+    }
+};
+
+// Send the pieces of a serialized Message in order
+inline ssize_t sendPieces(int socket,
+                          const std::vector<Serializer::Piece>& pieces) {
+    return PendingSend(pieces).send(socket);
+}
+
+// Receive an entire block of data. Messages are read in place as they
+// arrive, so never read past the end of the block.
 inline ssize_t recvData(int socket, void* buf, size_t bytes) {
     ssize_t totalRecvd = 0;
     ssize_t bytesLeft = bytes;
@@ -120,14 +186,16 @@ inline ssize_t recvData(int socket, void* buf, size_t bytes) {
 
     uint8_t* dataStart = static_cast<uint8_t*>(buf);
 
-    while (totalRecvd < static_cast<ssize_t>(bytes)) {
+    while (bytesLeft) {
         recvd = recv(socket, dataStart + totalRecvd, bytesLeft, 0);
-        if (recvd == -1 || recvd == 0) break;
+        if (recvd == -1 && errno == EINTR) continue;
+        if (recvd == -1) return -errno;
+        if (recvd == 0) return -ECONNRESET;
         totalRecvd += recvd;
-        bytesLeft += recvd;
+        bytesLeft -= recvd;
     }
 
-    return recvd == -1 ? -errno : 0;
+    return 0;
 }
 
 // Receives bytes amount of data from socket and appends it to current
@@ -0,0 +1,92 @@
+/**
+ * @file frame.cpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#include "frame.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+FrameStream::FrameStream(uint64_t total) : _total(total) {}
+
+uint64_t FrameStream::total() const { return _total; }
+
+bool FrameStream::complete() {
+    const std::lock_guard<std::mutex> lock(_lock);
+    return _received >= _total;
+}
+
+uint64_t FrameStream::buffered() {
+    const std::lock_guard<std::mutex> lock(_lock);
+    return _buffered;
+}
+
+// The frame is read with the lock released, so the reading thread carries on
+// with frames that already arrived meanwhile
+ssize_t FrameStream::push(uint64_t offset, uint64_t length,
+                          const Serial::Reader& read) {
+    std::vector<uint8_t> bytes(length);
+    ssize_t ret = read(bytes.data(), length);
+
+    const std::lock_guard<std::mutex> lock(_lock);
+    _received += length;
+    if (ret || !length || _detached || _closed) return ret;
+
+    if (_frames.emplace(offset, std::move(bytes)).second) _buffered += length;
+    _cv.notify_all();
+    return 0;
+}
+
+void FrameStream::detach() {
+    const std::lock_guard<std::mutex> lock(_lock);
+    _detached = true;
+    _frames.clear();
+    _buffered = 0;
+}
+
+void FrameStream::close() {
+    const std::lock_guard<std::mutex> lock(_lock);
+    _closed = true;
+    _cv.notify_all();
+}
+
+// Frames never overlap, so the next bytes are always at the start of the
+// first frame left once it has arrived
+ssize_t FrameStream::read(void* buf, size_t bytes) {
+    uint8_t* out = static_cast<uint8_t*>(buf);
+    std::unique_lock<std::mutex> lock(_lock);
+    if (bytes > _total - _offset) return -EINVAL;
+
+    while (bytes) {
+        _cv.wait(lock, [this] {
+            return _closed ||
+                   (!_frames.empty() && _frames.begin()->first <= _offset);
+        });
+        if (_frames.empty() || _frames.begin()->first > _offset) {
+            return -ECONNRESET;
+        }
+
+        auto frame = _frames.begin();
+        size_t skip = _offset - frame->first;
+        if (skip >= frame->second.size()) return -EINVAL;
+        size_t len = std::min(bytes, frame->second.size() - skip);
+        memcpy(out, frame->second.data() + skip, len);
+        if (skip + len == frame->second.size()) {
+            _buffered -= frame->second.size();
+            _frames.erase(frame);
+        }
+
+        out += len;
+        bytes -= len;
+        _offset += len;
+    }
+
+    return 0;
+}
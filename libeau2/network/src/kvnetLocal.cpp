@@ -0,0 +1,108 @@
+/**
+ * @file kvnetLocal.cpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#include "kvnetLocal.hpp"
+
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include "message.hpp"
+
+// Index 0 is the registrar's, which in a single process is no one
+KVNetLocal::Cluster::Cluster(size_t nodes) : _size(nodes), _nodes(1) {}
+
+KVNetLocal::KVNetLocal(Cluster& cluster) : _cluster(cluster) {}
+
+// The index stays taken so that nodes keep theirs
+KVNetLocal::~KVNetLocal() {
+    const std::lock_guard<std::mutex> lock(_cluster._lock);
+    if (_idx) _cluster._nodes[_idx] = nullptr;
+}
+
+size_t KVNetLocal::registerNode(const char* address, const char* port) {
+    const std::lock_guard<std::mutex> lock(_cluster._lock);
+    // Can't register more than once
+    if (_idx) throw std::runtime_error("Node is already registered");
+    if (_cluster._nodes.size() > _cluster._size) {
+        throw std::runtime_error("Cluster is already full");
+    }
+
+    _idx = _cluster._nodes.size();
+    _cluster._nodes.push_back(this);
+    _up = true;
+    _cluster._changed.notify_all();
+    std::cout << "Node is index " << _idx << std::endl;
+
+    return _idx;
+}
+
+// Holding the cluster's lock keeps the target from going away meanwhile
+void KVNetLocal::send(std::shared_ptr<Message> msg) {
+    const std::lock_guard<std::mutex> lock(_cluster._lock);
+    uint64_t target = msg->target();
+    if (target >= _cluster._nodes.size() || !_cluster._nodes[target]) {
+        std::cerr << "Unknown node " << target << ", dropping message\n";
+        return;
+    }
+
+    _cluster._nodes[target]->_deliver(std::move(msg));
+}
+
+std::shared_ptr<Message> KVNetLocal::receive() {
+    const std::lock_guard<std::mutex> lock(_receiveLock);
+    if (_receiving.empty()) return nullptr;
+
+    std::shared_ptr<Message> msg = std::move(_receiving.front());
+    _receiving.pop();
+    return msg;
+}
+
+// Messages received before shutdown() are still handed out
+std::shared_ptr<Message> KVNetLocal::waitAndReceive() {
+    std::unique_lock<std::mutex> lock(_receiveLock);
+    _received.wait(lock,
+                   [this] { return !_receiving.empty() || _stopped; });
+    if (_receiving.empty()) return nullptr;
+
+    std::shared_ptr<Message> msg = std::move(_receiving.front());
+    _receiving.pop();
+    return msg;
+}
+
+// Like KVNetTCP, blocks until the node registered and the cluster is up
+bool KVNetLocal::ready() {
+    std::unique_lock<std::mutex> lock(_cluster._lock);
+    _cluster._changed.wait(lock, [this] {
+        return (_up && _cluster._nodes.size() > _cluster._size) ||
+               (_idx && !_up);
+    });
+
+    return _up;
+}
+
+void KVNetLocal::shutdown() {
+    {
+        const std::lock_guard<std::mutex> lock(_cluster._lock);
+        _up = false;
+        _cluster._changed.notify_all();
+    }
+    {
+        const std::lock_guard<std::mutex> lock(_receiveLock);
+        _stopped = true;
+    }
+    _received.notify_all();
+}
+
+void KVNetLocal::_deliver(std::shared_ptr<Message> msg) {
+    {
+        const std::lock_guard<std::mutex> lock(_receiveLock);
+        _receiving.push(std::move(msg));
+    }
+    _received.notify_one();
+}
@@ -10,12 +10,16 @@
 
 #include <arpa/inet.h>
 #include <netdb.h>
+#include <fcntl.h>
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <stack>
@@ -27,6 +31,7 @@
 #include "message.hpp"
 #include "register.hpp"
 #include "serial.hpp"
+#include "serializer.hpp"
 #include "tcpUtils.hpp"
 
 namespace {
@@ -34,15 +39,113 @@ constexpr const char* REGISTRAR = "127.0.0.1";
 constexpr const char* PORT = "4500";
 constexpr size_t MAX_EVENTS = 10;
 constexpr int POLL_TIMEOUT_MS = 500;
+constexpr size_t FRAME_BYTES = 256 * 1024;  // most bytes of a message a
+                                            // frame carries
+constexpr int SHM_RETRY_MS = 10;  // between attempts to open a node's ring
+constexpr size_t DECODERS = 4;    // messages split over frames deserialized
+                                  // at once, the frames of others are kept
+constexpr size_t MAX_DECODERS = 32;  // decoders started as frames pile up
+constexpr uint64_t MAX_WAITING_BYTES =
+    64 << 20;  // bytes of frames kept for messages waiting for a decoder
+               // before another decoder is started
 }  // namespace
 
-KVNetTCP::KVNetTCP() {}
+// The Serializer keeps the bytes referenced by the pieces, the Message keeps
+// the Columns it references alive
+struct KVNetTCP::Outgoing {
+    std::shared_ptr<Message> msg;
+    Serializer ss;
+    std::vector<Serializer::Piece> pieces;
+    uint64_t stream;         // tells it apart from other messages in flight
+    uint64_t total;          // length of the message
+    uint64_t offset = 0;     // bytes cut into frames so far
+    uint64_t unsent;         // bytes of frames not yet written
+    size_t piece = 0;        // first piece not entirely cut
+    size_t pieceOffset = 0;  // bytes of it cut
+
+    Outgoing(std::shared_ptr<Message> message, uint64_t id)
+        : msg(std::move(message)), stream(id) {
+        msg->serializeTo(ss);
+        pieces = ss.pieces();
+        total = unsent = ss.size();
+    }
+
+    // Cuts up to the given number of bytes off the front of what is left
+    std::vector<Serializer::Piece> cut(size_t bytes) {
+        std::vector<Serializer::Piece> slice;
+        while (bytes && piece < pieces.size()) {
+            const Serializer::Piece& next = pieces[piece];
+            size_t len = std::min(bytes, next.size - pieceOffset);
+            slice.push_back({next.data + pieceOffset, len});
+
+            bytes -= len;
+            offset += len;
+            pieceOffset += len;
+            if (pieceOffset == next.size) {
+                piece++;
+                pieceOffset = 0;
+            }
+        }
+
+        return slice;
+    }
+};
+
+// Frames of unframed peers are whole messages without a header. Frames are
+// not moved once made, as their header is sent from where it is.
+struct KVNetTCP::Frame {
+    std::shared_ptr<Outgoing> out;  // the message the frame is cut from
+    FrameHeader header;
+    TCP::PendingSend pending;
+
+    Frame(std::shared_ptr<Outgoing> message, bool framed)
+        : out(std::move(message)) {
+        header.sender = out->msg->sender();
+        header.stream = out->stream;
+        header.total = out->total;
+        header.offset = out->offset;
+
+        std::vector<Serializer::Piece> pieces;
+        if (framed) {
+            pieces.push_back(
+                {reinterpret_cast<const uint8_t*>(&header), sizeof(header)});
+        }
+        std::vector<Serializer::Piece> slice =
+            out->cut(framed ? FRAME_BYTES : out->total);
+        pieces.insert(pieces.end(), slice.begin(), slice.end());
+
+        header.length = out->offset - header.offset;
+        pending = TCP::PendingSend(pieces);
+    }
+};
+
+KVNetTCP::KVNetTCP(size_t connections, bool sharedMemory)
+    : _connections(std::max<size_t>(connections, 1)),
+      _sharedMemory(sharedMemory) {
+    _wakeFd = eventfd(0, EFD_NONBLOCK);
+    if (_wakeFd == -1) throw std::runtime_error("Failed to create eventfd");
+}
+
 KVNetTCP::~KVNetTCP() {
     shutdown();
     std::cout << "Shutting down network...";
     // Wait for sender and receiver to stop
     _senderThread.join();
     _receiverThread.join();
+    for (std::thread& decoder : _decoders) decoder.join();
+
+    // Closing the rings stops the shared memory threads
+    for (auto& [target, link] : _shmLinks) {
+        {
+            const std::lock_guard<std::mutex> lock(link->lock);
+            if (link->ring) link->ring->close();
+        }
+        link->writer.join();
+    }
+    for (std::unique_ptr<ShmRing>& ring : _shmRings) ring->close();
+    for (std::thread& reader : _shmReaders) reader.join();
+
+    close(_wakeFd);
     std::cout << " done." << std::endl;
 }
 
@@ -92,11 +195,20 @@ size_t KVNetTCP::registerNode(const char* address, const char* port) {
     _dir.insert(std::end(_dir), std::begin(dirMsg->dir()),
                 std::end(dirMsg->dir()));
 
+    if (_sharedMemory) _openShm();
+
     // start sender and receiver
     _senderThread = std::thread(&KVNetTCP::_sender, this);
     _receiverThread = std::thread(&KVNetTCP::_receiver, this, port);
+    for (size_t ii = 0; ii < DECODERS; ii++)
+        _decoders.emplace_back(&KVNetTCP::_decoder, this);
 
-    _netUp = true;
+    {
+        const std::lock_guard<std::mutex> lock(_upLock);
+        _netUp = true;
+        _wasUp = true;
+    }
+    _upChanged.notify_all();
 
     return _idx;
 }
@@ -104,24 +216,44 @@ size_t KVNetTCP::registerNode(const char* address, const char* port) {
 // Might want to play around with serialization here instead of in event handler
 // Adds a Message to be sent
 void KVNetTCP::send(std::shared_ptr<Message> msg) {
-    // Loopback interface
+    // Loopback interface, the message is handed over as it is
     if (msg->target() == _idx) {
-        std::unique_ptr<Message> msgCopy =
-            Message::deserialize(msg->serialize());
-        const std::lock_guard<std::mutex> lock(_receiveLock);
-        _receiving.push(std::move(msgCopy));
-    } else {
+        {
+            const std::lock_guard<std::mutex> lock(_receiveLock);
+            _receiving.push(std::move(msg));
+        }
+        _received.notify_one();
+        return;
+    }
+
+    if (_shmLinks.count(msg->target())) {
+        ShmLink& link = *_shmLinks[msg->target()];
+        const std::lock_guard<std::mutex> lock(link.lock);
+        if (!link.broken) {
+            link.queue.push(std::move(msg));
+            link.queued.notify_one();
+            return;
+        }
+    }
+
+    _sendTcp(std::move(msg));
+}
+
+void KVNetTCP::_sendTcp(std::shared_ptr<Message> msg) {
+    {
         const std::lock_guard<std::mutex> lock(_sendLock);
-        _sending.push(msg);
-        _senderCv.notify_all();
+        _sending.push(std::move(msg));
     }
+    uint64_t one = 1;
+    if (write(_wakeFd, &one, sizeof(one)) == -1 && errno != EAGAIN)
+        std::cerr << "Failed to wake sender\n";
 }
 
 // Removes a Message that has been received for processing
-std::unique_ptr<Message> KVNetTCP::receive() {
+std::shared_ptr<Message> KVNetTCP::receive() {
     const std::lock_guard<std::mutex> lock(_receiveLock);
     if (!_receiving.empty()) {
-        std::unique_ptr<Message> msg = std::move(_receiving.front());
+        std::shared_ptr<Message> msg = std::move(_receiving.front());
         _receiving.pop();
         return msg;
     }
@@ -129,25 +261,44 @@ std::unique_ptr<Message> KVNetTCP::receive() {
     return nullptr;
 }
 
-bool KVNetTCP::ready() {
-    static std::atomic_bool wasReady = false;
-
-    if (wasReady) return _netUp;
-    // if (!_netUp) {
-    //     std::this_thread::sleep_for(std::chrono::milliseconds(POLL_TIMEOUT_MS));
-    // }
+// Messages received before shutdown() are still handed out
+std::shared_ptr<Message> KVNetTCP::waitAndReceive() {
+    std::unique_lock<std::mutex> lock(_receiveLock);
+    _received.wait(lock,
+                   [this] { return !_receiving.empty() || _stopped; });
+    if (_receiving.empty()) return nullptr;
 
-    // For debug, we want to block indefinitely
-    while (!_netUp) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    }
+    std::shared_ptr<Message> msg = std::move(_receiving.front());
+    _receiving.pop();
+    return msg;
+}
 
-    wasReady = wasReady || _netUp;
+// Blocks until registerNode() brings the network up for the first time
+bool KVNetTCP::ready() {
+    std::unique_lock<std::mutex> lock(_upLock);
+    _upChanged.wait(lock, [this] { return _wasUp; });
 
     return _netUp;
 }
 
-void KVNetTCP::shutdown() { _netUp = false; }
+void KVNetTCP::shutdown() {
+    _netUp = false;
+    // _netUp is also false before registering, so waiting for messages
+    // ends on a flag of its own
+    {
+        const std::lock_guard<std::mutex> lock(_receiveLock);
+        _stopped = true;
+    }
+    _received.notify_all();
+    {
+        const std::lock_guard<std::mutex> lock(_decodeLock);
+        _decodeQueued.notify_all();
+    }
+    for (auto& [target, link] : _shmLinks) {
+        const std::lock_guard<std::mutex> lock(link->lock);
+        link->queued.notify_all();
+    }
+}
 
 // Reads in Message bytestream from node and deserializes
 std::unique_ptr<Message> KVNetTCP::_readMsg(int sock) {
@@ -166,11 +317,12 @@ std::unique_ptr<Message> KVNetTCP::_readMsg(int sock) {
         case MsgKind::Kill:
             break;
         case MsgKind::Put:
-            if (_readPut(sock, *msg)) return nullptr;
-            break;
         case MsgKind::Reply:
-            if (_readReply(sock, *msg)) return nullptr;
-            break;
+            // Streamed so that large payloads are not buffered first
+            return Message::receive(msg->data(),
+                                    [sock](void* buf, size_t bytes) {
+                                        return TCP::recvData(sock, buf, bytes);
+                                    });
         case MsgKind::Get:
             if (_readGet(sock, *msg)) return nullptr;
             break;
@@ -242,40 +394,6 @@ ssize_t KVNetTCP::_readPayload(int sock, std::vector<uint8_t>& msg) {
     return 0;
 }
 
-// Reads bytestream for Put
-ssize_t KVNetTCP::_readPut(int sock, std::vector<uint8_t>& msg) {
-    ssize_t ret;
-
-    if ((ret = TCP::recvData(sock, msg, 2 * sizeof(uint64_t)))) {
-        std::cerr << "Failed to get Put data\n";
-        return ret;
-    }
-
-    if ((ret = _readPayload(sock, msg))) {
-        std::cerr << "Failed to get Put key\n";
-        return ret;
-    }
-
-    if ((ret = _readPayload(sock, msg))) {
-        std::cerr << "Failed to get Put payload\n";
-        return ret;
-    }
-
-    return 0;
-}
-
-// Reads bytestream for Reply
-ssize_t KVNetTCP::_readReply(int sock, std::vector<uint8_t>& msg) {
-    ssize_t ret;
-
-    if ((ret = _readPayload(sock, msg))) {
-        std::cerr << "Failed to get Reply payload\n";
-        return ret;
-    }
-
-    return 0;
-}
-
 // Reads bytestream for Get
 ssize_t KVNetTCP::_readGet(int sock, std::vector<uint8_t>& msg) {
     ssize_t ret;
@@ -334,57 +452,168 @@ ssize_t KVNetTCP::_readDirectory(int sock, std::vector<uint8_t>& msg) {
     return 0;
 }
 
+// Queued messages are handed over through _sending, everything else belongs
+// to this thread. Sockets are only watched while they have messages to send,
+// so a slow node only holds up its own messages.
 void KVNetTCP::_sender() {
-    // Delay if network status isn't set as up, shouldn't take more than 500 ms
-    // to change
+    // Wait for registerNode() to mark the network as up
     ready();
 
+    struct epoll_event ev, events[MAX_EVENTS];
+    int epollfd = epoll_create1(0);
+    if (epollfd == -1) {
+        throw std::runtime_error("Failed to create epoll instance");
+    }
+
+    ev.events = EPOLLIN;
+    ev.data.fd = _wakeFd;
+    if (epoll_ctl(epollfd, EPOLL_CTL_ADD, _wakeFd, &ev) == -1) {
+        throw std::runtime_error("Failed to add eventfd to epoll");
+    }
+
+    std::unordered_map<uint64_t, Peer> peers;  // by node index
+    std::unordered_map<int, std::pair<uint64_t, size_t>>
+        conns;  // node index and connection index by socket
+
+    // The registrar's connection is already up and stays blocking for the
+    // receiver, sends to it just don't wait
+    peers[0].framed = false;
+    peers[0].conns.emplace_back();
+    peers[0].conns[0].sock = _sendSocks[0];
+    peers[0].conns[0].connected = true;
+    conns[_sendSocks[0]] = {0, 0};
+
     while (_netUp) {
-        // Go to sleep if nothing is waiting to be sent
-        std::unique_lock<std::mutex> lock(_sendLock);
-        if (_senderCv.wait_for(lock, std::chrono::milliseconds(POLL_TIMEOUT_MS),
-                               [this] { return !_sending.empty(); })) {
-            while (!_sending.empty()) {
-                // Send all pending Messages
-                std::shared_ptr<Message> msg = _sending.front();
-                _sending.pop();
-
-                uint64_t target = msg->target();
-
-                if (!_sendSocks.count(target)) {
-                    // No existing connection, create socket
-                    char connIP[INET_ADDRSTRLEN];
-                    auto connPort =
-                        std::to_string(htons(_dir[target].sin_port));
-
-                    struct addrinfo* connAddrinfo = TCP::generateAddrinfo(
-                        connPort.c_str(),
-                        inet_ntop(AF_INET, &(_dir[target].sin_addr), connIP,
-                                  sizeof(connIP)));
-
-                    _sendSocks[target] = TCP::createSocket(connAddrinfo);
-
-                    if (connect(_sendSocks[target], connAddrinfo->ai_addr,
-                                connAddrinfo->ai_addrlen) == -1) {
-                        close(_sendSocks[target]);
-                        freeaddrinfo(connAddrinfo);
+        int readyfds = epoll_wait(epollfd, events, MAX_EVENTS, POLL_TIMEOUT_MS);
+
+        for (int ii = 0; ii < readyfds; ii++) {
+            if (events[ii].data.fd == _wakeFd) {
+                uint64_t count;
+                if (read(_wakeFd, &count, sizeof(count)) == -1 &&
+                    errno != EAGAIN) {
+                    std::cerr << "Failed to read eventfd\n";
+                }
+
+                std::queue<std::shared_ptr<Message>> queued;
+                {
+                    const std::lock_guard<std::mutex> lock(_sendLock);
+                    std::swap(queued, _sending);
+                }
+
+                while (!queued.empty()) {
+                    uint64_t target = queued.front()->target();
+                    Peer& peer = peers[target];
+                    if (peer.conns.empty()) {
+                        peer.conns.resize(_connections);
+                        for (size_t jj = 0; jj < _connections; jj++) {
+                            _connect(target, peer.conns[jj]);
+                            conns[peer.conns[jj].sock] = {target, jj};
+                        }
+                    }
+
+                    peer.queue.push_back(std::make_shared<Outgoing>(
+                        std::move(queued.front()), _nextStream++));
+                    queued.pop();
+
+                    for (Conn& conn : peer.conns) {
+                        if (conn.connected) _flush(target, peer, conn);
+                    }
+                    for (Conn& conn : peer.conns) _watch(epollfd, peer, conn);
+                }
+            } else {
+                auto [target, idx] = conns[events[ii].data.fd];
+                Peer& peer = peers[target];
+                Conn& conn = peer.conns[idx];
+
+                if (!conn.connected) {
+                    int err = 0;
+                    socklen_t len = sizeof(err);
+                    getsockopt(conn.sock, SOL_SOCKET, SO_ERROR, &err, &len);
+                    if (err) {
                         std::cerr << "Failed to connect to node " << target
                                   << '\n';
                         throw std::runtime_error("Unable to connect to node");
                     }
-
-                    freeaddrinfo(connAddrinfo);
-                }
-
-                if (TCP::sendPacket(_sendSocks[target], msg->serialize())) {
-                    throw std::runtime_error("Failed to send Message");
+                    conn.connected = true;
                 }
 
-                std::cout << "Network message sent: " << msg->sender() << " -> "
-                          << msg->target() << std::endl;
+                _flush(target, peer, conn);
+                _watch(epollfd, peer, conn);
             }
         }
     }
+
+    // Shut down, the registrar's socket is closed by the receiver
+    for (auto& [target, peer] : peers) {
+        if (!target) continue;
+        for (Conn& conn : peer.conns) close(conn.sock);
+    }
+    close(epollfd);
+}
+
+void KVNetTCP::_connect(uint64_t target, Conn& conn) {
+    char connIP[INET_ADDRSTRLEN];
+    auto connPort = std::to_string(htons(_dir[target].sin_port));
+
+    struct addrinfo* connAddrinfo = TCP::generateAddrinfo(
+        connPort.c_str(), inet_ntop(AF_INET, &(_dir[target].sin_addr), connIP,
+                                    sizeof(connIP)));
+
+    conn.sock = TCP::createSocket(connAddrinfo);
+    fcntl(conn.sock, F_SETFL, fcntl(conn.sock, F_GETFL) | O_NONBLOCK);
+
+    if (connect(conn.sock, connAddrinfo->ai_addr, connAddrinfo->ai_addrlen) ==
+        0) {
+        conn.connected = true;
+    } else if (errno != EINPROGRESS) {
+        close(conn.sock);
+        freeaddrinfo(connAddrinfo);
+        std::cerr << "Failed to connect to node " << target << '\n';
+        throw std::runtime_error("Unable to connect to node");
+    }
+
+    freeaddrinfo(connAddrinfo);
+}
+
+// A message with frames left goes to the back of the queue once a frame is
+// cut from it, so small messages wait for at most a frame of each large one
+void KVNetTCP::_flush(uint64_t target, Peer& peer, Conn& conn) {
+    while (conn.frame || !peer.queue.empty()) {
+        if (!conn.frame) {
+            std::shared_ptr<Outgoing> out = std::move(peer.queue.front());
+            peer.queue.pop_front();
+            conn.frame = std::make_unique<Frame>(out, peer.framed);
+            if (out->offset < out->total) peer.queue.push_back(out);
+        }
+
+        if (conn.frame->pending.send(conn.sock, MSG_DONTWAIT)) {
+            throw std::runtime_error("Failed to send Message");
+        }
+        if (!conn.frame->pending.done()) return;
+
+        Outgoing& out = *conn.frame->out;
+        out.unsent -= conn.frame->header.length;
+        if (!out.unsent) {
+            std::cout << "Network message sent: " << out.msg->sender()
+                      << " -> " << target << std::endl;
+        }
+        conn.frame.reset();
+    }
+}
+
+// A connection in progress is writable once it is up
+void KVNetTCP::_watch(int epollfd, const Peer& peer, Conn& conn) {
+    bool pending = !conn.connected || conn.frame || !peer.queue.empty();
+    if (pending == conn.watched) return;
+
+    struct epoll_event ev;
+    ev.events = EPOLLOUT;
+    ev.data.fd = conn.sock;
+    if (epoll_ctl(epollfd, pending ? EPOLL_CTL_ADD : EPOLL_CTL_DEL, conn.sock,
+                  &ev) == -1) {
+        throw std::runtime_error("Failed to watch socket");
+    }
+    conn.watched = pending;
 }
 
 void KVNetTCP::_receiver(const char* port) {
@@ -423,8 +652,7 @@ void KVNetTCP::_receiver(const char* port) {
     struct sockaddr_storage connAddr;
     socklen_t addrLen;
 
-    // Delay if network status isn't set as up, shouldn't take more than 500 ms
-    // to change
+    // Wait for registerNode() to mark the network as up
     ready();
 
     while (_netUp) {
@@ -461,6 +689,13 @@ void KVNetTCP::_receiver(const char* port) {
                 sockfds.push_back(connSock);
                 std::cout << "Added new connection " << connSock << std::endl;
             } else if (events[ii].events & EPOLLIN) {
+                // The registrar sends whole messages, nodes send frames
+                if (events[ii].data.fd != _sendSocks[0]) {
+                    if (_readFrame(events[ii].data.fd))
+                        std::cerr << "Invalid frame received\n";
+                    continue;
+                }
+
                 std::unique_ptr<Message> msg = _readMsg(events[ii].data.fd);
 
                 if (!msg) {
@@ -468,25 +703,298 @@ void KVNetTCP::_receiver(const char* port) {
                     continue;
                 }
 
-                if (msg->target() != _idx) {
-                    std::cerr << "Message not for this node, dropping\n";
-                    continue;
-                }
-
-                const std::lock_guard<std::mutex> lock(_receiveLock);
-                std::cout << "Network message received: " << msg->sender()
-                          << " -> " << msg->target() << std::endl;
-                _receiving.push(std::move(msg));
+                _deliver(std::move(msg));
             }
         }
     }
 
-    // Shut down
+    // Shut down, messages still being deserialized give up
+    for (auto& [key, stream] : _streams) stream->close();
+    _streams.clear();
     for (int& sockfd : sockfds) {
         close(sockfd);
     }
 }
 
+// Messages that fit in one frame are deserialized right away, read from the
+// socket straight into the message where possible. The frames of others are
+// kept for a decoder to read as they arrive, so the receiver never waits for
+// one.
+ssize_t KVNetTCP::_readFrame(int sock) {
+    ssize_t ret;
+    FrameHeader header;
+    if ((ret = TCP::recvData(sock, &header, sizeof(header)))) return ret;
+    if (header.offset > header.total ||
+        header.length > header.total - header.offset) {
+        return -EINVAL;
+    }
+
+    if (header.length == header.total) {
+        // Whatever an invalid message leaves of the frame is skipped
+        uint64_t left = header.length;
+        ssize_t err = 0;
+        std::unique_ptr<Message> msg =
+            _readWhole([&](void* buf, size_t bytes) -> ssize_t {
+                if (bytes > left) return -EINVAL;
+                left -= bytes;
+                return err = TCP::recvData(sock, buf, bytes);
+            }, header.total);
+        if (err) return err;
+
+        if (!msg) {
+            std::cerr << "Invalid Message received\n";
+            std::vector<uint8_t> rest(left);
+            return TCP::recvData(sock, rest.data(), left);
+        }
+
+        _deliver(std::move(msg));
+        return 0;
+    }
+
+    auto key = std::make_pair(header.sender, header.stream);
+    std::shared_ptr<FrameStream> stream = _streams[key];
+    if (!stream) {
+        stream = _streams[key] = std::make_shared<FrameStream>(header.total);
+        {
+            const std::lock_guard<std::mutex> lock(_decodeLock);
+            _undecoded.push_back(stream);
+        }
+        _decodeQueued.notify_one();
+    }
+
+    ret = stream->push(header.offset, header.length,
+                       [sock](void* buf, size_t bytes) {
+                           return TCP::recvData(sock, buf, bytes);
+                       });
+    if (!ret) _limitWaiting(header.sender, stream);
+    if (stream->complete()) _streams.erase(key);
+
+    return ret;
+}
+
+// Frames are kept for messages until a decoder gets to them. Past
+// MAX_WAITING_BYTES another decoder is started, and once there are
+// MAX_DECODERS the message that went over is dropped instead.
+void KVNetTCP::_limitWaiting(uint64_t sender,
+                             const std::shared_ptr<FrameStream>& stream) {
+    std::unique_lock<std::mutex> lock(_decodeLock);
+    uint64_t waiting = 0;
+    for (const std::shared_ptr<FrameStream>& queued : _undecoded) {
+        waiting += queued->buffered();
+    }
+    if (waiting <= MAX_WAITING_BYTES || _idleDecoders) return;
+
+    if (_decoders.size() < MAX_DECODERS) {
+        _decoders.emplace_back(&KVNetTCP::_decoder, this);
+        return;
+    }
+
+    auto queued = std::find(_undecoded.begin(), _undecoded.end(), stream);
+    if (queued == _undecoded.end()) return;
+    _undecoded.erase(queued);
+    lock.unlock();
+
+    stream->close();
+    std::cerr << "Too many frames waiting to be decoded, dropping message from "
+              << sender << std::endl;
+}
+
+void KVNetTCP::_decoder() {
+    ready();
+
+    while (true) {
+        std::shared_ptr<FrameStream> stream;
+        {
+            std::unique_lock<std::mutex> lock(_decodeLock);
+            _idleDecoders++;
+            _decodeQueued.wait(
+                lock, [this] { return !_undecoded.empty() || !_netUp; });
+            _idleDecoders--;
+            if (!_netUp) return;
+            stream = std::move(_undecoded.front());
+            _undecoded.pop_front();
+        }
+
+        _decode(std::move(stream));
+    }
+}
+
+void KVNetTCP::_decode(std::shared_ptr<FrameStream> stream) {
+    std::unique_ptr<Message> msg = _readWhole(
+        [&stream](void* buf, size_t bytes) {
+            return stream->read(buf, bytes);
+        },
+        stream->total());
+    stream->detach();
+
+    if (!msg) {
+        std::cerr << "Invalid Message received\n";
+        return;
+    }
+
+    _deliver(std::move(msg));
+}
+
+// Put and Reply are read straight into their Columns, other messages are
+// collected and deserialized whole
+std::unique_ptr<Message> KVNetTCP::_readWhole(const Serial::Reader& read,
+                                              uint64_t total) {
+    if (total < Serial::CMD_HDR_SIZE) return nullptr;
+
+    auto bytes = std::make_unique<std::vector<uint8_t>>(Serial::CMD_HDR_SIZE);
+    if (read(bytes->data(), Serial::CMD_HDR_SIZE)) {
+        std::cerr << "Failed to get command header\n";
+        return nullptr;
+    }
+
+    switch (Message::valueToMsgKind((*bytes)[0])) {
+        case MsgKind::Put:
+        case MsgKind::Reply:
+            return Message::receive(bytes->data(), read);
+        default:
+            bytes->resize(total);
+            if (read(bytes->data() + Serial::CMD_HDR_SIZE,
+                     total - Serial::CMD_HDR_SIZE)) {
+                return nullptr;
+            }
+            return Message::deserialize(std::move(bytes));
+    }
+}
+
+void KVNetTCP::_deliver(std::shared_ptr<Message> msg) {
+    if (msg->target() != _idx) {
+        std::cerr << "Message not for this node, dropping\n";
+        return;
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(_receiveLock);
+        std::cout << "Network message received: " << msg->sender() << " -> "
+                  << msg->target() << std::endl;
+        _receiving.push(std::move(msg));
+    }
+    _received.notify_one();
+}
+
+std::string KVNetTCP::_shmName(const struct sockaddr_in& from,
+                               const struct sockaddr_in& to) {
+    char addr[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &from.sin_addr, addr, sizeof(addr));
+    return std::string("/eau2-") + addr + '-' +
+           std::to_string(ntohs(from.sin_port)) + '-' +
+           std::to_string(ntohs(to.sin_port));
+}
+
+// Every node reads from a ring of its own per node on the same host. The
+// registrar sends the directory once every node registered, so a node may
+// go to open a ring before its reader created it, or while one left behind
+// by an earlier run is still there, see ShmRing::open(). The registrar is
+// always reached over TCP.
+void KVNetTCP::_openShm() {
+    const struct sockaddr_in& self = _dir[_idx];
+    for (uint64_t ii = 1; ii < _dir.size(); ii++) {
+        if (ii == _idx || _dir[ii].sin_addr.s_addr != self.sin_addr.s_addr)
+            continue;
+
+        std::unique_ptr<ShmRing> ring =
+            ShmRing::create(_shmName(_dir[ii], self));
+        if (!ring) throw std::runtime_error("Unable to create shared memory");
+        _shmRings.push_back(std::move(ring));
+
+        auto link = std::make_unique<ShmLink>();
+        link->name = _shmName(self, _dir[ii]);
+        _shmLinks[ii] = std::move(link);
+    }
+
+    for (std::unique_ptr<ShmRing>& ring : _shmRings) {
+        _shmReaders.emplace_back(&KVNetTCP::_shmReader, this,
+                                 std::ref(*ring));
+    }
+    for (auto& [target, link] : _shmLinks) {
+        link->writer = std::thread(&KVNetTCP::_shmWriter, this, target,
+                                   std::ref(*link));
+    }
+}
+
+// Messages are written whole, each after its length. The node's ring may
+// not exist yet when the first message to it is queued. Once writing to it
+// fails the link is broken: the message and those still queued go over TCP
+// instead, and so does everything sent to the node afterwards, so nothing
+// is released as sent without having been.
+void KVNetTCP::_shmWriter(uint64_t target, ShmLink& link) {
+    ready();
+
+    while (true) {
+        std::shared_ptr<Message> msg;
+        {
+            std::unique_lock<std::mutex> lock(link.lock);
+            link.queued.wait(
+                lock, [&] { return !link.queue.empty() || !_netUp; });
+            if (!_netUp) return;
+            msg = std::move(link.queue.front());
+            link.queue.pop();
+        }
+
+        // Opening waits for the node to acknowledge, so it is done without
+        // holding up send()
+        while (!link.ring) {
+            std::unique_ptr<ShmRing> ring = ShmRing::open(link.name);
+            {
+                const std::lock_guard<std::mutex> lock(link.lock);
+                if (!_netUp) return;
+                link.ring = std::move(ring);
+            }
+            if (!link.ring) {
+                std::this_thread::sleep_for(
+                    std::chrono::milliseconds(SHM_RETRY_MS));
+            }
+        }
+
+        Serializer ss;
+        msg->serializeTo(ss);
+        uint64_t total = ss.size();
+        std::vector<Serializer::Piece> pieces = ss.pieces();
+        pieces.insert(pieces.begin(),
+                      {reinterpret_cast<const uint8_t*>(&total),
+                       sizeof(total)});
+        if (link.ring->write(pieces) != 0) {
+            if (!_netUp) return;
+            std::cerr << "Failed to write to node " << target
+                      << ", sending over TCP\n";
+            // Under the link's lock send() cannot queue behind these
+            const std::lock_guard<std::mutex> lock(link.lock);
+            link.broken = true;
+            _sendTcp(std::move(msg));
+            for (; !link.queue.empty(); link.queue.pop())
+                _sendTcp(std::move(link.queue.front()));
+            return;
+        }
+
+        std::cout << "Network message sent: " << msg->sender() << " -> "
+                  << target << std::endl;
+    }
+}
+
+void KVNetTCP::_shmReader(ShmRing& ring) {
+    Serial::Reader read = [&ring](void* buf, size_t bytes) {
+        return ring.read(buf, bytes);
+    };
+
+    uint64_t total;
+    while (!read(&total, sizeof(total))) {
+        std::unique_ptr<Message> msg = _readWhole(read, total);
+        if (!msg) {
+            // The rest of the ring can't be made sense of, closing it lets
+            // the writer know
+            std::cerr << "Invalid Message received\n";
+            ring.close();
+            return;
+        }
+
+        _deliver(std::move(msg));
+    }
+}
+
 // Checks if an address is a known IP in the directory
 bool KVNetTCP::_inDirectory(in_addr_t address) {
     for (struct sockaddr_in& context : _dir) {
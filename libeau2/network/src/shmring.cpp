@@ -0,0 +1,272 @@
+/**
+ * @file shmring.cpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#include "shmring.hpp"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <random>
+
+namespace {
+constexpr uint64_t MAGIC = 0x65617532524e4721;  // set once set up
+constexpr long WAIT_TIMEOUT_NS = 100 * 1000 * 1000;  // between closed checks
+constexpr long ACK_TIMEOUT_NS = 1000 * 1000 * 1000;  // for the reader to
+                                                     // acknowledge a writer
+
+// The time the given number of nanoseconds from now
+struct timespec deadlineIn(long ns) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += ns / (1000 * 1000 * 1000);
+    deadline.tv_nsec += ns % (1000 * 1000 * 1000);
+    if (deadline.tv_nsec >= 1000 * 1000 * 1000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000 * 1000 * 1000;
+    }
+
+    return deadline;
+}
+}  // namespace
+
+// Only the writer moves head and only the reader moves tail, each copies
+// outside of the lock and then publishes the move under it
+struct ShmRing::Header {
+    std::atomic<uint64_t> magic;  // MAGIC once the creator has set it up
+    pthread_mutex_t lock;
+    pthread_cond_t changed;  // broadcast when head or tail move, or on close
+    uint64_t capacity;       // bytes in the ring
+    uint64_t head;           // bytes written so far
+    uint64_t tail;           // bytes read so far
+    uint64_t opened;         // nonce of the writer that opened it last
+    uint64_t acked;          // opened, once the reader saw it
+    uint32_t closed;         // whether either side closed the ring
+};
+
+ShmRing::ShmRing(const std::string& name, void* map, size_t mapBytes,
+                 bool owner)
+    : _name(name),
+      _header(static_cast<Header*>(map)),
+      _data(static_cast<uint8_t*>(map) + sizeof(Header)),
+      _mapBytes(mapBytes),
+      _owner(owner) {}
+
+std::unique_ptr<ShmRing> ShmRing::create(const std::string& name,
+                                         size_t capacity) {
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd == -1) {
+        std::cerr << "Could not create shared memory " << name << '\n';
+        return nullptr;
+    }
+
+    size_t mapBytes = sizeof(Header) + capacity;
+    void* map = MAP_FAILED;
+    if (ftruncate(fd, mapBytes) == 0) {
+        map = mmap(nullptr, mapBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                   0);
+    }
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        std::cerr << "Could not map shared memory " << name << '\n';
+        return nullptr;
+    }
+
+    Header* header = new (map) Header;
+    header->capacity = capacity;
+    header->head = 0;
+    header->tail = 0;
+    header->opened = 0;
+    header->acked = 0;
+    header->closed = 0;
+
+    pthread_mutexattr_t mutexAttr;
+    pthread_mutexattr_init(&mutexAttr);
+    pthread_mutexattr_setpshared(&mutexAttr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&mutexAttr, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&header->lock, &mutexAttr);
+    pthread_mutexattr_destroy(&mutexAttr);
+
+    pthread_condattr_t condAttr;
+    pthread_condattr_init(&condAttr);
+    pthread_condattr_setpshared(&condAttr, PTHREAD_PROCESS_SHARED);
+    pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC);
+    pthread_cond_init(&header->changed, &condAttr);
+    pthread_condattr_destroy(&condAttr);
+
+    header->magic.store(MAGIC, std::memory_order_release);
+
+    return std::unique_ptr<ShmRing>(new ShmRing(name, map, mapBytes, true));
+}
+
+std::unique_ptr<ShmRing> ShmRing::open(const std::string& name) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd == -1) return nullptr;
+
+    struct stat st;
+    void* map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 &&
+        static_cast<size_t>(st.st_size) > sizeof(Header)) {
+        map = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                   fd, 0);
+    }
+    ::close(fd);
+    if (map == MAP_FAILED) return nullptr;
+
+    Header* header = static_cast<Header*>(map);
+    if (header->magic.load(std::memory_order_acquire) != MAGIC ||
+        header->capacity != st.st_size - sizeof(Header)) {
+        munmap(map, st.st_size);
+        return nullptr;
+    }
+
+    // A ring left behind by a run that crashed looks set up as well, but
+    // nobody acknowledges the writer
+    std::random_device random;
+    uint64_t nonce = static_cast<uint64_t>(random()) << 32 | random();
+    struct timespec deadline = deadlineIn(ACK_TIMEOUT_NS);
+    _lock(header);
+    header->opened = nonce;
+    pthread_cond_broadcast(&header->changed);
+    int ret = 0;
+    while (header->acked != nonce && !header->closed && ret != ETIMEDOUT) {
+        ret = pthread_cond_timedwait(&header->changed, &header->lock,
+                                     &deadline);
+        if (ret == EOWNERDEAD) _recover(header);
+    }
+    bool acked = header->acked == nonce && !header->closed;
+    pthread_mutex_unlock(&header->lock);
+    if (!acked) {
+        munmap(map, st.st_size);
+        return nullptr;
+    }
+
+    return std::unique_ptr<ShmRing>(new ShmRing(name, map, st.st_size, false));
+}
+
+ShmRing::~ShmRing() {
+    close();
+    munmap(_header, _mapBytes);
+    if (_owner) shm_unlink(_name.c_str());
+}
+
+void ShmRing::_lock(Header* header) {
+    if (pthread_mutex_lock(&header->lock) == EOWNERDEAD) _recover(header);
+}
+
+void ShmRing::_recover(Header* header) {
+    pthread_mutex_consistent(&header->lock);
+    header->closed = 1;
+    pthread_cond_broadcast(&header->changed);
+}
+
+// Waits time out now and then so that a side closing the ring is noticed
+// even if the other side went away without waking it. What was written
+// before the other side closed can still be read.
+template <typename P>
+bool ShmRing::_wait(P pred) {
+    while (true) {
+        if (_owner && _header->acked != _header->opened) {
+            _header->acked = _header->opened;
+            pthread_cond_broadcast(&_header->changed);
+        }
+        if (_closed || _header->closed || pred()) break;
+
+        struct timespec deadline = deadlineIn(WAIT_TIMEOUT_NS);
+        if (pthread_cond_timedwait(&_header->changed, &_header->lock,
+                                   &deadline) == EOWNERDEAD) {
+            _recover(_header);
+        }
+    }
+
+    return !_closed && pred();
+}
+
+ssize_t ShmRing::write(const std::vector<Serializer::Piece>& pieces) {
+    uint64_t capacity = _header->capacity;
+
+    for (const Serializer::Piece& piece : pieces) {
+        const uint8_t* in = piece.data;
+        size_t size = piece.size;
+
+        while (size) {
+            _lock(_header);
+            bool open = _wait([&] {
+                return _header->head - _header->tail < capacity;
+            }) && !_header->closed;
+            uint64_t head = _header->head;
+            uint64_t space = capacity - (head - _header->tail);
+            pthread_mutex_unlock(&_header->lock);
+            if (!open) return -EPIPE;
+
+            size_t len = std::min<uint64_t>(size, space);
+            size_t start = head % capacity;
+            size_t first = std::min<uint64_t>(len, capacity - start);
+            memcpy(_data + start, in, first);
+            memcpy(_data, in + first, len - first);
+
+            _lock(_header);
+            _header->head += len;
+            pthread_cond_broadcast(&_header->changed);
+            pthread_mutex_unlock(&_header->lock);
+
+            in += len;
+            size -= len;
+        }
+    }
+
+    return 0;
+}
+
+ssize_t ShmRing::read(void* buf, size_t bytes) {
+    uint64_t capacity = _header->capacity;
+    uint8_t* out = static_cast<uint8_t*>(buf);
+
+    while (bytes) {
+        _lock(_header);
+        bool open = _wait([&] { return _header->head != _header->tail; });
+        uint64_t tail = _header->tail;
+        uint64_t ready = _header->head - tail;
+        pthread_mutex_unlock(&_header->lock);
+        if (!open) return -EPIPE;
+
+        size_t len = std::min<uint64_t>(bytes, ready);
+        size_t start = tail % capacity;
+        size_t first = std::min<uint64_t>(len, capacity - start);
+        memcpy(out, _data + start, first);
+        memcpy(out + first, _data, len - first);
+
+        _lock(_header);
+        _header->tail += len;
+        pthread_cond_broadcast(&_header->changed);
+        pthread_mutex_unlock(&_header->lock);
+
+        out += len;
+        bytes -= len;
+    }
+
+    return 0;
+}
+
+void ShmRing::close() {
+    if (_closed.exchange(true)) return;
+
+    _lock(_header);
+    _header->closed = 1;
+    pthread_cond_broadcast(&_header->changed);
+    pthread_mutex_unlock(&_header->lock);
+}
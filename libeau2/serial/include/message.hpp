@@ -11,9 +11,12 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <vector>
 
+#include "serial.hpp"
+
 class Serializer;
 
 /**
@@ -43,6 +46,7 @@ class Message {
     uint64_t _sender;  // the index of the sender node
     uint64_t _target;  // the index of the receiver node
     uint64_t _id;      // an id t unique within the node
+    std::function<void()> _onRelease;  // called when destroyed, if set
     inline static std::atomic_uint64_t _nextID = 0;
 
    protected:
@@ -69,6 +73,14 @@ class Message {
     virtual uint64_t target() final;
     virtual uint64_t id() final;
 
+    /**
+     * @brief Sets a function to call when the message is destroyed, which
+     * for a message sent is once the network has written or dropped it
+     *
+     * @param callback
+     */
+    void onRelease(std::function<void()> callback);
+
     /**
      * @brief Get the next (sequential) ID
      *
@@ -83,6 +95,16 @@ class Message {
      */
     virtual std::unique_ptr<std::vector<uint8_t>> serialize() = 0;
 
+    /**
+     * @brief Serialize the message into the serializer given. Messages that
+     * carry large payloads reference them in place, so they can be sent as
+     * Serializer::pieces() without being flattened. The message must outlive
+     * the serializer's output. Adds the bytes of serialize() by default.
+     *
+     * @param ss serializer to use
+     */
+    virtual void serializeTo(Serializer& ss);
+
     /**
      * @brief Builds the header for the command
      *
@@ -114,4 +136,16 @@ class Message {
      */
     static std::unique_ptr<Message> deserialize(
         std::unique_ptr<std::vector<uint8_t>> bytestream);
+
+    /**
+     * @brief Reads the rest of a Put or Reply from a stream as it arrives,
+     * so that their columns are read straight into place
+     *
+     * @param cmdHdr the command header, already read
+     * @param read reads the rest of the message
+     * @return std::unique_ptr<Message> the message, nullptr if it could not
+     * be read or is of another kind
+     */
+    static std::unique_ptr<Message> receive(const uint8_t* cmdHdr,
+                                            const Serial::Reader& read);
 };
\ No newline at end of file
@@ -17,6 +17,7 @@
 #include "serial.hpp"
 
 class Serializer;
+class StringDict;
 
 // Serialized data to include with messages
 class Payload {
@@ -25,6 +26,10 @@ class Payload {
     Serial::Type _colType = Serial::Type::Unknown;
     std::vector<uint8_t> _data;
     std::shared_ptr<void> _ref = nullptr;
+    std::vector<const StringDict*>* _sentDicts =
+        nullptr;  // dictionaries already sent with the same DataFrame
+    std::vector<std::shared_ptr<StringDict>>* _receivedDicts =
+        nullptr;  // dictionaries received with the same DataFrame
 
     void _setupThisPayload(Serializer& ss, uint64_t remaining);
     void _serializeColumn(Serializer& ss);
@@ -33,8 +38,27 @@ class Payload {
                                    BStreamIter end);
     BStreamIter _deserializeDataFrame(uint64_t& payloadsLeft, BStreamIter start,
                                       BStreamIter end);
+    void _unpackCol(const uint8_t* data, size_t size, uint64_t& payloadsLeft);
+    // Gives up on Column data that can't be unpacked, leaving no Column
+    void _fail(const char* why, uint64_t& payloadsLeft);
+    void _applyValidity();
+    static bool _addColumn(DataFrame& df, Payload& col);
+    static bool _receiveHeader(const Serial::Reader& read, Serial::Type& type,
+                               uint64_t& payloadsLeft, uint64_t& size);
+    bool _receiveColumn(const Serial::Reader& read, uint64_t& payloadsLeft);
+    bool _receiveDataFrame(const Serial::Reader& read, uint64_t& payloadsLeft);
     template <typename T>
-    void _unpackAsCol(Payload& colData, uint64_t& payloadsLeft);
+    bool _receiveAsCol(const Serial::Reader& read, uint64_t size,
+                       uint64_t& payloadsLeft);
+    template <typename T>
+    void _unpackAsCol(const uint8_t* data, size_t size, uint64_t& payloadsLeft);
+    void _unpackAsDictCol(const uint8_t* data, size_t size,
+                          uint64_t& payloadsLeft);
+    void _unpackAsEncodedCol(const uint8_t* data, size_t size,
+                             uint64_t& payloadsLeft);
+    template <typename T>
+    void _unpackEncodedChunks(const uint8_t* data, size_t size,
+                              uint64_t& payloadsLeft);
 
     friend class Serializer;
 
@@ -54,10 +78,26 @@ class Payload {
 
     bool add(DFPtr value);
 
+    // Adds size bytes of NUL terminated strings packed back to back
+    bool addStrings(const char* strings, size_t size);
+
+    // Appends size raw bytes to a Payload of the given type
+    bool addBytes(Serial::Type type, const void* bytes, size_t size);
+
     void serialize(Serializer& ss);
 
+    // Writes the header of a Payload whose size bytes of data the caller
+    // adds right after, so they can be referenced rather than copied
+    static void serializeHeader(Serializer& ss, Serial::Type type,
+                                uint64_t remaining, uint64_t size);
+
     BStreamIter deserialize(BStreamIter start, BStreamIter end);
 
+    // Reads a Payload from a stream as it arrives. Headers are read first so
+    // that plain Column items can be read straight into the Column's chunks.
+    // Returns false if the stream failed or the Payload is malformed.
+    bool receive(const Serial::Reader& read);
+
     template <typename T>
     ColPtr<T> asColumn();
 
@@ -82,22 +82,38 @@ inline ColPtr<T> Payload::asColumn() {
     return std::dynamic_pointer_cast<Column<T>>(col);
 }
 
+// The Column is sized up front and each chunk is read in place
 template <typename T>
-inline void Payload::_unpackAsCol(Payload& colData, uint64_t& payloadsLeft) {
-    auto col = std::make_shared<Column<T>>();
-
-    if (colData._data.size() % sizeof(T) != 0) {
+inline bool Payload::_receiveAsCol(const Serial::Reader& read, uint64_t size,
+                                   uint64_t& payloadsLeft) {
+    if (size % sizeof(T) != 0) {
         std::cerr << "Column data size mismatch\n";
-        return;
+        return false;
     }
 
-    size_t numItems = colData._data.size() / sizeof(T);
+    auto col = std::make_shared<Column<T>>();
+    col->resize(size / sizeof(T));
+    for (size_t ii = 0; ii < col->blocks(); ii++) {
+        if (read(col->chunkData(ii), col->block(ii).size() * sizeof(T)))
+            return false;
+    }
 
-    T* item = reinterpret_cast<T*>(colData._data.data());
+    _ref = col;
+    _applyValidity();
 
-    for (size_t ii = 0; ii < numItems; ii++) {
-        col->push_back(*item++);
-    }
+    payloadsLeft--;
+    return true;
+}
+
+// Items are copied from the stream straight into the Column's chunks
+template <typename T>
+inline void Payload::_unpackAsCol(const uint8_t* data, size_t size,
+                                  uint64_t& payloadsLeft) {
+    if (size % sizeof(T) != 0)
+        return _fail("Column data size mismatch", payloadsLeft);
+
+    auto col = std::make_shared<Column<T>>();
+    col->appendBytes(data, size / sizeof(T));
 
     _ref = col;
 
@@ -105,5 +121,9 @@ inline void Payload::_unpackAsCol(Payload& colData, uint64_t& payloadsLeft) {
 }
 
 template <>
-inline void Payload::_unpackAsCol<ExtString>(Payload& colData,
-                                             uint64_t& payloadsLeft);
\ No newline at end of file
+void Payload::_unpackAsCol<ExtString>(const uint8_t* data, size_t size,
+                                      uint64_t& payloadsLeft);
+
+template <>
+void Payload::_unpackAsCol<bool>(const uint8_t* data, size_t size,
+                                 uint64_t& payloadsLeft);
\ No newline at end of file
@@ -27,8 +27,12 @@ class Put : public Message {
     static std::unique_ptr<Message> deserializeAs(BStreamIter start,
                                                   BStreamIter end);
 
+    static std::unique_ptr<Message> receiveAs(const Serial::Reader& read);
+
     friend std::unique_ptr<Message> Message::deserialize(
         std::unique_ptr<std::vector<uint8_t>>);
+    friend std::unique_ptr<Message> Message::receive(const uint8_t*,
+                                                     const Serial::Reader&);
 
    public:
     Put(uint64_t sender, const Key& key, DFPtr value,
@@ -38,4 +42,6 @@ class Put : public Message {
     DFPtr value();
 
     std::unique_ptr<std::vector<uint8_t>> serialize() override;
+
+    void serializeTo(Serializer& ss) override;
 };
\ No newline at end of file
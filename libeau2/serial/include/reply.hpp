@@ -25,8 +25,12 @@ class Reply : public Message {
     static std::unique_ptr<Message> deserializeAs(BStreamIter start,
                                                   BStreamIter end);
 
+    static std::unique_ptr<Message> receiveAs(const Serial::Reader& read);
+
     friend std::unique_ptr<Message> Message::deserialize(
         std::unique_ptr<std::vector<uint8_t>>);
+    friend std::unique_ptr<Message> Message::receive(const uint8_t*,
+                                                     const Serial::Reader&);
 
    public:
     Reply(size_t sender, size_t target, size_t id);
@@ -37,6 +41,8 @@ class Reply : public Message {
     std::shared_ptr<Payload> payload();
 
     std::unique_ptr<std::vector<uint8_t>> serialize() override;
+
+    void serializeTo(Serializer& ss) override;
 };
 
 #include "reply.tpp"
\ No newline at end of file
@@ -9,11 +9,17 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 
 #include "commondefs.hpp"
 namespace Serial {
 constexpr ssize_t CMD_HDR_SIZE = 25;
 constexpr ssize_t PAYLOAD_HDR_SIZE = 17;
+constexpr size_t ENCODED_CHUNK_HDR_SIZE = 13;  // encoding, items and length
+
+// Reads exactly the given number of bytes from a stream into the buffer given,
+// returning 0 on success. Used to deserialize Messages as they arrive.
+using Reader = std::function<ssize_t(void* buf, size_t bytes)>;
 
 enum class Type {
     U8 = 0,
@@ -31,6 +37,8 @@ enum class Type {
     Column = 12,
     Key = 13,
     DataFrame = 14,
+    DictString = 15,
+    Encoded = 16,
     Unknown
 };
 
@@ -66,6 +74,10 @@ inline Type valueToType(uint8_t value) {
             return Type::Key;
         case static_cast<uint8_t>(Type::DataFrame):
             return Type::DataFrame;
+        case static_cast<uint8_t>(Type::DictString):
+            return Type::DictString;
+        case static_cast<uint8_t>(Type::Encoded):
+            return Type::Encoded;
         default:
             return Type::Unknown;
     }
@@ -103,6 +115,10 @@ inline uint8_t typeToValue(Type type) {
             return static_cast<uint8_t>(Type::Key);
         case Type::DataFrame:
             return static_cast<uint8_t>(Type::DataFrame);
+        case Type::DictString:
+            return static_cast<uint8_t>(Type::DictString);
+        case Type::Encoded:
+            return static_cast<uint8_t>(Type::Encoded);
         default:
             return UINT8_MAX;
     }
@@ -15,11 +15,32 @@
 
 #include "commondefs.hpp"
 
-// Builds a serial bytestream of items
+// Builds a serial bytestream of items. Large runs of bytes can be referenced
+// in place instead of copied, the bytestream is then gathered from the copied
+// bytes and the referenced ones.
 class Serializer {
+   public:
+    // A contiguous piece of the bytestream
+    struct Piece {
+        const uint8_t* data;
+        size_t size;
+    };
+
+    // Referenced runs shorter than this are copied instead
+    static constexpr size_t MIN_REF_BYTES = 1024;
+
    private:
+    // Referenced bytes, placed at an offset of the copied bytes
+    struct Ref {
+        size_t offset;
+        const uint8_t* data;
+        size_t size;
+    };
+
     std::unique_ptr<std::vector<uint8_t>> _bytestream =
         std::make_unique<std::vector<uint8_t>>();
+    std::vector<Ref> _refs;  // in order of offset
+    size_t _refBytes = 0;    // total size of _refs
 
    public:
     Serializer();
@@ -33,9 +54,20 @@ class Serializer {
     template <typename T>
     Serializer& add(std::vector<T> vector);
 
-    Serializer& addBytes(void* bytes, size_t size);
+    Serializer& addBytes(const void* bytes, size_t size);
+
+    // Adds size bytes without copying them. They must stay alive and
+    // unchanged until the bytestream is generated or its pieces are used.
+    Serializer& addRef(const void* bytes, size_t size);
+
+    // Length of the bytestream
+    size_t size() const;
+
+    // The bytestream as pieces in order, pointing into this Serializer and
+    // the referenced bytes. Valid until the Serializer is changed.
+    std::vector<Piece> pieces() const;
 
     std::unique_ptr<std::vector<uint8_t>> generate();
 };
 
-#include "serializer.tpp"
\ No newline at end of file
+#include "serializer.tpp"
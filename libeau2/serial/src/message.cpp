@@ -8,8 +8,10 @@
 
 #include "message.hpp"
 
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
+#include <utility>
 
 #include "ack.hpp"
 #include "commondefs.hpp"
@@ -26,13 +28,19 @@
 
 Message::Message(MsgKind kind, size_t sender, size_t target, size_t id)
     : _kind(kind), _sender(sender), _target(target), _id(id) {}
-Message::~Message() {}
+Message::~Message() {
+    if (_onRelease) _onRelease();
+}
 
 MsgKind Message::kind() { return _kind; }
 uint64_t Message::sender() { return _sender; }
 uint64_t Message::target() { return _target; }
 uint64_t Message::id() { return _id; }
 
+void Message::onRelease(std::function<void()> callback) {
+    _onRelease = std::move(callback);
+}
+
 size_t Message::getNextID() { return _nextID++; }
 
 /**
@@ -51,6 +59,11 @@ void Message::setupCmdHdr(Serializer& s) {
     s.add(msgKindToValue(_kind)).add(_sender).add(_target).add(_id);
 }
 
+void Message::serializeTo(Serializer& ss) {
+    std::unique_ptr<std::vector<uint8_t>> bytes = serialize();
+    if (bytes) ss.addBytes(bytes->data(), bytes->size());
+}
+
 uint8_t Message::msgKindToValue(MsgKind kind) {
     switch (kind) {
         case MsgKind::Ack:
@@ -162,4 +175,38 @@ std::unique_ptr<Message> Message::deserialize(
     msg->_id = id;
 
     return msg;
-}
\ No newline at end of file
+}
+
+std::unique_ptr<Message> Message::receive(const uint8_t* cmdHdr,
+                                          const Serial::Reader& read) {
+    MsgKind kind = valueToMsgKind(cmdHdr[0]);
+    uint64_t sender, target, id;
+    memcpy(&sender, cmdHdr + 1, sizeof(uint64_t));
+    memcpy(&target, cmdHdr + 1 + sizeof(uint64_t), sizeof(uint64_t));
+    memcpy(&id, cmdHdr + 1 + 2 * sizeof(uint64_t), sizeof(uint64_t));
+
+    std::unique_ptr<Message> msg;
+
+    switch (kind) {
+        case MsgKind::Put:
+            msg = Put::receiveAs(read);
+            break;
+        case MsgKind::Reply:
+            msg = Reply::receiveAs(read);
+            break;
+        default:
+            std::cerr << "Only Put and Reply Messages can be received\n";
+            return nullptr;
+    }
+
+    if (!msg) {
+        std::cerr << "Failed to receive Message\n";
+        return nullptr;
+    }
+
+    msg->_sender = sender;
+    msg->_target = target;
+    msg->_id = id;
+
+    return msg;
+}
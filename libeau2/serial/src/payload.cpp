@@ -45,6 +45,23 @@ bool Payload::add(ExtString value) {
     return true;
 }
 
+bool Payload::addStrings(const char* strings, size_t size) {
+    return addBytes(Serial::Type::String, strings, size);
+}
+
+bool Payload::addBytes(Serial::Type type, const void* bytes, size_t size) {
+    if (_type != Serial::Type::Unknown && _type != type) {
+        std::cerr << "Payload is already set\n";
+        return false;
+    }
+
+    _type = type;
+    const uint8_t* data = static_cast<const uint8_t*>(bytes);
+    _data.insert(_data.end(), data, data + size);
+
+    return true;
+}
+
 template <>
 bool Payload::add(Key value) {
     if (_type != Serial::Type::Unknown) {
@@ -155,18 +172,36 @@ DFPtr Payload::asDataFrame() {
     return std::static_pointer_cast<DataFrame>(_ref);
 }
 
+void Payload::serializeHeader(Serializer& ss, Serial::Type type,
+                              uint64_t remaining, uint64_t size) {
+    ss.add(Serial::typeToValue(type)).add(remaining).add(size);
+}
+
 void Payload::_setupThisPayload(Serializer& ss, uint64_t remaining) {
-    ss.add(Serial::typeToValue(_type))
-        .add(remaining)
-        .add(static_cast<uint64_t>(_data.size()));
-    for (uint8_t& byte : _data) ss.add(byte);
+    serializeHeader(ss, _type, remaining, _data.size());
+    ss.addBytes(_data.data(), _data.size());
 }
 
+// The outer payload carries the column's validity bitmap, which is left empty
+// when nothing is missing
 void Payload::_serializeColumn(Serializer& ss) {
-    _setupThisPayload(ss, 1);
     auto col = std::static_pointer_cast<ColumnInterface>(_ref);
     if (!col) throw std::runtime_error("Invalid Column reference");
-    col->serialize(ss);
+
+    _data.clear();
+    if (const Bitmap* present = col->validity().present()) {
+        auto bytes = reinterpret_cast<const uint8_t*>(present->words());
+        _data.assign(bytes, bytes + (present->size() + 7) / 8);
+    }
+
+    _setupThisPayload(ss, 1);
+
+    auto strings = std::dynamic_pointer_cast<Column<ExtString>>(col);
+    if (strings && _sentDicts) {
+        strings->serialize(ss, *_sentDicts);
+    } else {
+        col->serialize(ss);
+    }
 }
 
 void Payload::_serializeDataFrame(Serializer& ss) {
@@ -175,9 +210,11 @@ void Payload::_serializeDataFrame(Serializer& ss) {
     _setupThisPayload(ss, df->ncols());
 
     Schema& dfSchema = df->getSchema();
+    std::vector<const StringDict*> dicts;  // sent once, shared by columns
 
     for (size_t ii = 0; ii < df->ncols(); ii++) {
         Payload col;
+        col._sentDicts = &dicts;
         switch (dfSchema.colSerialType(ii)) {
             case Serial::Type::U8:
                 col.add(
@@ -233,6 +270,113 @@ void Payload::_serializeDataFrame(Serializer& ss) {
     }
 }
 
+bool Payload::receive(const Serial::Reader& read) {
+    uint64_t payloadsLeft;
+    uint64_t dataSize;
+    if (!_receiveHeader(read, _type, payloadsLeft, dataSize)) return false;
+
+    _data.resize(dataSize);
+    if (dataSize && read(_data.data(), dataSize)) return false;
+
+    bool ok = true;
+    switch (_type) {
+        case Serial::Type::Column:
+            ok = _receiveColumn(read, payloadsLeft);
+            break;
+        case Serial::Type::DataFrame:
+            ok = _receiveDataFrame(read, payloadsLeft);
+            break;
+        default:
+            break;
+    }
+
+    if (ok && payloadsLeft)
+        std::cerr << payloadsLeft << " payloads left, expected none\n";
+
+    return ok;
+}
+
+bool Payload::_receiveHeader(const Serial::Reader& read, Serial::Type& type,
+                             uint64_t& payloadsLeft, uint64_t& size) {
+    uint8_t header[Serial::PAYLOAD_HDR_SIZE];
+    if (read(header, sizeof(header))) return false;
+
+    type = Serial::valueToType(header[0]);
+    memcpy(&payloadsLeft, header + 1, sizeof(uint64_t));
+    memcpy(&size, header + 1 + sizeof(uint64_t), sizeof(uint64_t));
+
+    return true;
+}
+
+// Plain items are read into the Column's chunks, other layouts are buffered
+// and unpacked as when deserializing
+bool Payload::_receiveColumn(const Serial::Reader& read,
+                             uint64_t& payloadsLeft) {
+    if (payloadsLeft != 1) {
+        std::cerr << "Single Payload Columns supported at this time only\n";
+        return false;
+    }
+
+    uint64_t colPayloadsLeft;
+    uint64_t size;
+    if (!_receiveHeader(read, _colType, colPayloadsLeft, size)) return false;
+    if (colPayloadsLeft) {
+        std::cerr << colPayloadsLeft << " payloads left, expected none\n";
+        return false;
+    }
+
+    switch (_colType) {
+        case Serial::Type::U8:
+            return _receiveAsCol<uint8_t>(read, size, payloadsLeft);
+        case Serial::Type::I8:
+            return _receiveAsCol<int8_t>(read, size, payloadsLeft);
+        case Serial::Type::U16:
+            return _receiveAsCol<uint16_t>(read, size, payloadsLeft);
+        case Serial::Type::I16:
+            return _receiveAsCol<int16_t>(read, size, payloadsLeft);
+        case Serial::Type::U32:
+            return _receiveAsCol<uint32_t>(read, size, payloadsLeft);
+        case Serial::Type::I32:
+            return _receiveAsCol<int32_t>(read, size, payloadsLeft);
+        case Serial::Type::U64:
+            return _receiveAsCol<uint64_t>(read, size, payloadsLeft);
+        case Serial::Type::I64:
+            return _receiveAsCol<int64_t>(read, size, payloadsLeft);
+        case Serial::Type::Float:
+            return _receiveAsCol<float>(read, size, payloadsLeft);
+        case Serial::Type::Double:
+            return _receiveAsCol<double>(read, size, payloadsLeft);
+        default:
+            break;
+    }
+
+    std::vector<uint8_t> data(size);
+    if (size && read(data.data(), size)) return false;
+    _unpackCol(data.data(), size, payloadsLeft);
+    _applyValidity();
+
+    return _ref != nullptr;
+}
+
+bool Payload::_receiveDataFrame(const Serial::Reader& read,
+                                uint64_t& payloadsLeft) {
+    auto df = std::make_shared<DataFrame>();
+    std::vector<std::shared_ptr<StringDict>> dicts;
+
+    while (payloadsLeft) {
+        Payload col;
+        col._receivedDicts = &dicts;
+        if (!col.receive(read)) return false;
+        payloadsLeft--;
+
+        if (!_addColumn(*df, col)) return false;
+    }
+
+    _ref = df;
+
+    return true;
+}
+
 BStreamIter Payload::_deserializeColumn(uint64_t& payloadsLeft,
                                         BStreamIter start, BStreamIter end) {
     if (payloadsLeft != 1) {
@@ -240,137 +384,313 @@ BStreamIter Payload::_deserializeColumn(uint64_t& payloadsLeft,
         return start;
     }
 
-    Payload colData;
+    // The column's data is read in place rather than copied into a Payload
+    // first, it always comes last
+    if (std::distance(start, end) < Serial::PAYLOAD_HDR_SIZE)
+        throw std::invalid_argument("Payload is too small");
 
-    start = colData.deserialize(start, end);
+    _colType = Serial::valueToType(*start++);
+    uint64_t colPayloadsLeft;
+    uint64_t size;
+    memcpy(&colPayloadsLeft, &(*start), sizeof(uint64_t));
+    start += sizeof(uint64_t);
+    memcpy(&size, &(*start), sizeof(uint64_t));
+    start += sizeof(uint64_t);
+
+    if (std::distance(start, end) < static_cast<ssize_t>(size))
+        throw std::invalid_argument("Invalid Payload data");
+    if (colPayloadsLeft)
+        std::cerr << colPayloadsLeft << " payloads left, expected none\n";
+
+    const uint8_t* data = size ? &(*start) : nullptr;
+    start += size;
+
+    _unpackCol(data, size, payloadsLeft);
+    _applyValidity();
+
+    return start;
+}
+
+BStreamIter Payload::_deserializeDataFrame(uint64_t& payloadsLeft,
+                                           BStreamIter start, BStreamIter end) {
+    auto df = std::make_shared<DataFrame>();
+    std::vector<std::shared_ptr<StringDict>> dicts;
+
+    while (payloadsLeft) {
+        Payload col;
+        col._receivedDicts = &dicts;
+        start = col.deserialize(start, end);
+        payloadsLeft--;
 
-    _colType = colData.type();
+        if (!_addColumn(*df, col)) return start;
+    }
+
+    _ref = df;
 
+    return start;
+}
+
+// Unpacks Column data according to its type
+void Payload::_unpackCol(const uint8_t* data, size_t size,
+                         uint64_t& payloadsLeft) {
     switch (_colType) {
         case Serial::Type::U8:
-            _unpackAsCol<uint8_t>(colData, payloadsLeft);
+            _unpackAsCol<uint8_t>(data, size, payloadsLeft);
             break;
         case Serial::Type::I8:
-            _unpackAsCol<int8_t>(colData, payloadsLeft);
+            _unpackAsCol<int8_t>(data, size, payloadsLeft);
             break;
         case Serial::Type::U16:
-            _unpackAsCol<uint16_t>(colData, payloadsLeft);
+            _unpackAsCol<uint16_t>(data, size, payloadsLeft);
             break;
         case Serial::Type::I16:
-            _unpackAsCol<int16_t>(colData, payloadsLeft);
+            _unpackAsCol<int16_t>(data, size, payloadsLeft);
             break;
         case Serial::Type::U32:
-            _unpackAsCol<uint32_t>(colData, payloadsLeft);
+            _unpackAsCol<uint32_t>(data, size, payloadsLeft);
             break;
         case Serial::Type::I32:
-            _unpackAsCol<int32_t>(colData, payloadsLeft);
+            _unpackAsCol<int32_t>(data, size, payloadsLeft);
             break;
         case Serial::Type::U64:
-            _unpackAsCol<uint64_t>(colData, payloadsLeft);
+            _unpackAsCol<uint64_t>(data, size, payloadsLeft);
             break;
         case Serial::Type::I64:
-            _unpackAsCol<int64_t>(colData, payloadsLeft);
+            _unpackAsCol<int64_t>(data, size, payloadsLeft);
             break;
         case Serial::Type::Bool:
-            _unpackAsCol<bool>(colData, payloadsLeft);
+            _unpackAsCol<bool>(data, size, payloadsLeft);
             break;
         case Serial::Type::Float:
-            _unpackAsCol<float>(colData, payloadsLeft);
+            _unpackAsCol<float>(data, size, payloadsLeft);
             break;
         case Serial::Type::Double:
-            _unpackAsCol<double>(colData, payloadsLeft);
+            _unpackAsCol<double>(data, size, payloadsLeft);
             break;
         case Serial::Type::String:
-            _unpackAsCol<ExtString>(colData, payloadsLeft);
+            _unpackAsCol<ExtString>(data, size, payloadsLeft);
+            break;
+        case Serial::Type::DictString:
+            _unpackAsDictCol(data, size, payloadsLeft);
+            break;
+        case Serial::Type::Encoded:
+            _unpackAsEncodedCol(data, size, payloadsLeft);
             break;
         default:
-            std::cerr << "Unsupported Column type\n";
+            _fail("Unsupported Column type", payloadsLeft);
     }
-
-    return start;
 }
 
-BStreamIter Payload::_deserializeDataFrame(uint64_t& payloadsLeft,
-                                           BStreamIter start, BStreamIter end) {
-    auto df = std::make_shared<DataFrame>();
-
-    while (payloadsLeft) {
-        Payload col;
-        start = col.deserialize(start, end);
-        payloadsLeft--;
+void Payload::_fail(const char* why, uint64_t& payloadsLeft) {
+    std::cerr << why << '\n';
+    _ref = nullptr;
+    payloadsLeft--;
+}
 
-        switch (col._colType) {
-            case Serial::Type::U8:
-                df->addCol(std::static_pointer_cast<Column<uint8_t>>(col._ref));
-                break;
-            case Serial::Type::I8:
-                df->addCol(std::static_pointer_cast<Column<int8_t>>(col._ref));
-                break;
-            case Serial::Type::U16:
-                df->addCol(
-                    std::static_pointer_cast<Column<uint16_t>>(col._ref));
-                break;
-            case Serial::Type::I16:
-                df->addCol(std::static_pointer_cast<Column<int16_t>>(col._ref));
-                break;
-            case Serial::Type::U32:
-                df->addCol(
-                    std::static_pointer_cast<Column<uint32_t>>(col._ref));
-                break;
-            case Serial::Type::I32:
-                df->addCol(std::static_pointer_cast<Column<int32_t>>(col._ref));
-                break;
-            case Serial::Type::U64:
-                df->addCol(
-                    std::static_pointer_cast<Column<uint64_t>>(col._ref));
-                break;
-            case Serial::Type::I64:
-                df->addCol(std::static_pointer_cast<Column<int64_t>>(col._ref));
-                break;
-            case Serial::Type::Bool:
-                df->addCol(std::static_pointer_cast<Column<bool>>(col._ref));
-                break;
-            case Serial::Type::Float:
-                df->addCol(std::static_pointer_cast<Column<float>>(col._ref));
-                break;
-            case Serial::Type::Double:
-                df->addCol(std::static_pointer_cast<Column<double>>(col._ref));
-                break;
-            case Serial::Type::String:
-                df->addCol(
-                    std::static_pointer_cast<Column<ExtString>>(col._ref));
-                break;
-            default:
-                std::cerr << "Unexpected Payload, expected Column\n";
-                return start;
+// The outer Payload's data is the validity of the Column unpacked
+void Payload::_applyValidity() {
+    if (!_data.empty() && _ref) {
+        auto col = std::static_pointer_cast<ColumnInterface>(_ref);
+        if (_data.size() != (col->size() + 7) / 8) {
+            std::cerr << "Validity does not match the Column's length\n";
+        } else {
+            col->setValidity(Bitmap(_data.data(), col->size()));
         }
     }
+}
 
-    _ref = df;
+// Adds the Column a Payload was deserialized into to a DataFrame
+bool Payload::_addColumn(DataFrame& df, Payload& col) {
+    if (!col._ref) return false;
 
-    return start;
+    switch (col._colType) {
+        case Serial::Type::U8:
+            df.addCol(std::static_pointer_cast<Column<uint8_t>>(col._ref));
+            break;
+        case Serial::Type::I8:
+            df.addCol(std::static_pointer_cast<Column<int8_t>>(col._ref));
+            break;
+        case Serial::Type::U16:
+            df.addCol(std::static_pointer_cast<Column<uint16_t>>(col._ref));
+            break;
+        case Serial::Type::I16:
+            df.addCol(std::static_pointer_cast<Column<int16_t>>(col._ref));
+            break;
+        case Serial::Type::U32:
+            df.addCol(std::static_pointer_cast<Column<uint32_t>>(col._ref));
+            break;
+        case Serial::Type::I32:
+            df.addCol(std::static_pointer_cast<Column<int32_t>>(col._ref));
+            break;
+        case Serial::Type::U64:
+            df.addCol(std::static_pointer_cast<Column<uint64_t>>(col._ref));
+            break;
+        case Serial::Type::I64:
+            df.addCol(std::static_pointer_cast<Column<int64_t>>(col._ref));
+            break;
+        case Serial::Type::Bool:
+            df.addCol(std::static_pointer_cast<Column<bool>>(col._ref));
+            break;
+        case Serial::Type::Float:
+            df.addCol(std::static_pointer_cast<Column<float>>(col._ref));
+            break;
+        case Serial::Type::Double:
+            df.addCol(std::static_pointer_cast<Column<double>>(col._ref));
+            break;
+        case Serial::Type::String:
+        case Serial::Type::DictString:
+            df.addCol(std::static_pointer_cast<Column<ExtString>>(col._ref));
+            break;
+        default:
+            std::cerr << "Unexpected Payload, expected Column\n";
+            return false;
+    }
+
+    return true;
 }
 
 template <>
-void Payload::_unpackAsCol<ExtString>(Payload& colData,
+void Payload::_unpackAsCol<ExtString>(const uint8_t* data, size_t size,
                                       uint64_t& payloadsLeft) {
     auto col = std::make_shared<Column<ExtString>>();
 
-    auto string = std::make_shared<std::string>();
+    const char* strings = reinterpret_cast<const char*>(data);
+    col->pushPacked(strings, size);
 
-    for (uint8_t& cc : colData._data) {
-        if (cc == '\0') {
-            col->push_back(string);
-            string = std::make_shared<std::string>();
-        } else {
-            string->push_back(cc);
+    if (size && strings[size - 1] != '\0')
+        std::cerr << "Malformed data, last string not null terminated\n";
+
+    _ref = col;
+
+    payloadsLeft--;
+}
+
+// The item count, then the bits packed 8 to a byte
+template <>
+void Payload::_unpackAsCol<bool>(const uint8_t* data, size_t size,
+                                 uint64_t& payloadsLeft) {
+    uint64_t count = 0;
+    if (size >= sizeof(uint64_t)) memcpy(&count, data, sizeof(uint64_t));
+
+    if (size < sizeof(uint64_t) || (count + 7) / 8 != size - sizeof(uint64_t))
+        return _fail("Column data size mismatch", payloadsLeft);
+
+    _ref = std::make_shared<Column<bool>>(
+        Bitmap(data + sizeof(uint64_t), count));
+
+    payloadsLeft--;
+}
+
+// The dictionary's index among those of the DataFrame, followed by the size
+// of the packed dictionary and its strings the first time it is sent, then
+// the codes
+void Payload::_unpackAsDictCol(const uint8_t* data, size_t size,
+                               uint64_t& payloadsLeft) {
+    std::vector<std::shared_ptr<StringDict>> own;
+    std::vector<std::shared_ptr<StringDict>>& dicts =
+        _receivedDicts ? *_receivedDicts : own;
+
+    uint64_t dictIdx;
+    if (size < sizeof(dictIdx))
+        return _fail("Malformed dictionary Column data", payloadsLeft);
+    memcpy(&dictIdx, data, sizeof(dictIdx));
+    size_t pos = sizeof(dictIdx);
+    if (dictIdx > dicts.size())
+        return _fail("Unknown Column dictionary", payloadsLeft);
+
+    if (dictIdx == dicts.size()) {
+        uint64_t dictBytes;
+        if (size - pos < sizeof(dictBytes))
+            return _fail("Malformed dictionary Column data", payloadsLeft);
+        memcpy(&dictBytes, data + pos, sizeof(dictBytes));
+        pos += sizeof(dictBytes);
+        if (dictBytes > size - pos || (dictBytes && data[pos + dictBytes - 1]))
+            return _fail("Malformed dictionary Column data", payloadsLeft);
+
+        const char* strings = reinterpret_cast<const char*>(data + pos);
+        auto dict = std::make_shared<StringDict>();
+        for (const char* str = strings; str < strings + dictBytes;
+             str += strlen(str) + 1) {
+            dict->add(str);
         }
+        dicts.push_back(dict);
+        pos += dictBytes;
     }
 
-    if (!string->empty())
-        std::cerr << "Malformed data, last string not null terminated\n";
+    if ((size - pos) % sizeof(uint32_t) != 0)
+        return _fail("Malformed dictionary Column data", payloadsLeft);
+
+    const std::shared_ptr<StringDict>& dict = dicts[dictIdx];
+    auto col = std::make_shared<Column<ExtString>>(dict);
+    size_t numCodes = (size - pos) / sizeof(uint32_t);
+    for (size_t ii = 0; ii < numCodes; ii++) {
+        uint32_t code;
+        memcpy(&code, data + pos + ii * sizeof(uint32_t), sizeof(uint32_t));
+        if (code >= dict->size())
+            return _fail("Dictionary code out of range", payloadsLeft);
+        col->pushCode(code);
+    }
+
+    _ref = col;
+
+    payloadsLeft--;
+}
+
+// Chunks stay encoded in the Column they are unpacked into
+template <typename T>
+void Payload::_unpackEncodedChunks(const uint8_t* data, size_t size,
+                                   uint64_t& payloadsLeft) {
+    size_t pos = sizeof(uint8_t);
+
+    uint64_t count = 0;
+    if (size - pos >= sizeof(count)) memcpy(&count, data + pos, sizeof(count));
+    pos += sizeof(count);
+
+    auto col = std::make_shared<Column<T>>();
+    for (uint64_t ii = 0; ii < count; ii++) {
+        uint8_t encoding;
+        uint32_t items;
+        uint64_t length;
+        if (pos > size || size - pos < Serial::ENCODED_CHUNK_HDR_SIZE) break;
+        memcpy(&encoding, data + pos, sizeof(encoding));
+        memcpy(&items, data + pos + sizeof(encoding), sizeof(items));
+        memcpy(&length, data + pos + sizeof(encoding) + sizeof(items),
+               sizeof(length));
+        pos += Serial::ENCODED_CHUNK_HDR_SIZE;
+
+        EncodedChunk<T> chunk;
+        if (length > size - pos || items > Chunk<T>::size() ||
+            !EncodedChunk<T>::decode(static_cast<IntEncoding>(encoding), items,
+                                     data + pos, length, chunk)) {
+            break;
+        }
+        pos += length;
+        col->appendEncoded(std::move(chunk));
+    }
+
+    if (pos != size)
+        return _fail("Malformed encoded Column data", payloadsLeft);
 
     _ref = col;
 
     payloadsLeft--;
-}
\ No newline at end of file
+}
+
+// The item type comes first, the Column is then typed as if it had been sent
+// as plain items
+void Payload::_unpackAsEncodedCol(const uint8_t* data, size_t size,
+                                  uint64_t& payloadsLeft) {
+    if (!size) return _fail("Malformed encoded Column data", payloadsLeft);
+
+    _colType = Serial::valueToType(data[0]);
+    switch (_colType) {
+        case Serial::Type::I32:
+            _unpackEncodedChunks<int32_t>(data, size, payloadsLeft);
+            break;
+        case Serial::Type::I64:
+            _unpackEncodedChunks<int64_t>(data, size, payloadsLeft);
+            break;
+        default:
+            _fail("Unsupported encoded Column type", payloadsLeft);
+    }
+}
@@ -10,6 +10,7 @@
 
 #include <iostream>
 #include <iterator>
+#include <utility>
 
 #include "key.hpp"
 #include "payload.hpp"
@@ -20,7 +21,7 @@ Put::Put(uint64_t sender, const Key& key, DFPtr value, uint64_t colIdx,
          uint64_t rowIdx)
     : Message(MsgKind::Put, sender, key.home(), Message::getNextID()),
       _key(key),
-      _value(value),
+      _value(std::move(value)),
       _colIdx(colIdx),
       _rowIdx(rowIdx) {}
 
@@ -40,12 +41,14 @@ DFPtr Put::value() { return _value; }
  */
 std::unique_ptr<std::vector<uint8_t>> Put::serialize() {
     Serializer ss;
+    serializeTo(ss);
+    return ss.generate();
+}
 
+void Put::serializeTo(Serializer& ss) {
     setupCmdHdr(ss);
 
     ss.add(_colIdx).add(_rowIdx).add(_key).add(_value);
-
-    return ss.generate();
 }
 
 std::unique_ptr<Message> Put::deserializeAs(BStreamIter start,
@@ -78,4 +81,27 @@ std::unique_ptr<Message> Put::deserializeAs(BStreamIter start,
 
     return std::make_unique<Put>(0, key.asKey(), df.asDataFrame(), colIdx,
                                  rowIdx);
-}
\ No newline at end of file
+}
+
+std::unique_ptr<Message> Put::receiveAs(const Serial::Reader& read) {
+    uint64_t idx[2];
+    if (read(idx, sizeof(idx))) {
+        std::cerr << "Failed to get Put data\n";
+        return nullptr;
+    }
+
+    Payload key;
+    if (!key.receive(read) || key.type() != Serial::Type::Key) {
+        std::cerr << "Unexpected Put Key\n";
+        return nullptr;
+    }
+
+    Payload df;
+    if (!df.receive(read) || df.type() != Serial::Type::DataFrame) {
+        std::cerr << "Unexpected Put value\n";
+        return nullptr;
+    }
+
+    return std::make_unique<Put>(0, key.asKey(), df.asDataFrame(), idx[0],
+                                 idx[1]);
+}
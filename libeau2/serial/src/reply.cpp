@@ -29,16 +29,22 @@ std::shared_ptr<Payload> Reply::payload() { return _payload; }
  * @return std::unique_ptr<std::vector<uint8_t>>
  */
 std::unique_ptr<std::vector<uint8_t>> Reply::serialize() {
+    Serializer ss;
+    serializeTo(ss);
+    if (!ss.size()) return nullptr;
+
+    return ss.generate();
+}
+
+// Nothing is added for an empty Reply
+void Reply::serializeTo(Serializer& ss) {
     if (!_payload) {
         printf("Empty Reply\n");
-        return nullptr;
+        return;
     }
 
-    Serializer ss;
     setupCmdHdr(ss);
     _payload->serialize(ss);
-
-    return ss.generate();
 }
 
 std::unique_ptr<Message> Reply::deserializeAs(BStreamIter start,
@@ -56,4 +62,19 @@ std::unique_ptr<Message> Reply::deserializeAs(BStreamIter start,
     reply->_payload = payload;
 
     return reply;
-}
\ No newline at end of file
+}
+
+std::unique_ptr<Message> Reply::receiveAs(const Serial::Reader& read) {
+    auto payload = std::make_shared<Payload>();
+
+    if (!payload->receive(read) || payload->type() == Serial::Type::Unknown) {
+        std::cerr << "Cannot read Reply payload\n";
+        return nullptr;
+    }
+
+    auto reply = std::make_unique<Reply>(0, 0, 0);
+
+    reply->_payload = payload;
+
+    return reply;
+}
@@ -16,7 +16,7 @@ Serializer::Serializer() {}
 
 template <>
 Serializer& Serializer::add(const char* value) {
-    addBytes(const_cast<char*>(value), strlen(value) + 1);
+    addBytes(value, strlen(value) + 1);
     return *this;
 }
 
@@ -32,21 +32,67 @@ Serializer& Serializer::add(const std::string& value) {
  * @param size
  * @return Serializer&
  */
-Serializer& Serializer::addBytes(void* bytes, size_t size) {
-    uint8_t* data = static_cast<uint8_t*>(bytes);
-    for (size_t ii = 0; ii < size; ii++) _bytestream->push_back(data[ii]);
+Serializer& Serializer::addBytes(const void* bytes, size_t size) {
+    const uint8_t* data = static_cast<const uint8_t*>(bytes);
+    _bytestream->insert(_bytestream->end(), data, data + size);
     return *this;
 }
 
+Serializer& Serializer::addRef(const void* bytes, size_t size) {
+    if (size < MIN_REF_BYTES) return addBytes(bytes, size);
+
+    _refs.push_back(
+        {_bytestream->size(), static_cast<const uint8_t*>(bytes), size});
+    _refBytes += size;
+    return *this;
+}
+
+size_t Serializer::size() const { return _bytestream->size() + _refBytes; }
+
+// Copied bytes between two references become a piece of their own
+std::vector<Serializer::Piece> Serializer::pieces() const {
+    std::vector<Piece> pieces;
+    pieces.reserve(_refs.size() * 2 + 1);
+
+    size_t copied = 0;
+    for (const Ref& ref : _refs) {
+        if (ref.offset > copied) {
+            pieces.push_back(
+                {_bytestream->data() + copied, ref.offset - copied});
+        }
+        pieces.push_back({ref.data, ref.size});
+        copied = ref.offset;
+    }
+    if (_bytestream->size() > copied) {
+        pieces.push_back(
+            {_bytestream->data() + copied, _bytestream->size() - copied});
+    }
+
+    return pieces;
+}
+
 /**
  * @brief Finalizes the current buffer as a bytestream and clears buffer before
- * returning final bytestream
+ * returning final bytestream. Referenced bytes are copied in here, once.
  *
  * @return std::unique_ptr<std::vector<uint8_t>>
  */
 std::unique_ptr<std::vector<uint8_t>> Serializer::generate() {
-    _bytestream->shrink_to_fit();
-    std::unique_ptr<std::vector<uint8_t>> ret = std::move(_bytestream);
+    std::unique_ptr<std::vector<uint8_t>> ret;
+    if (_refs.empty()) {
+        _bytestream->shrink_to_fit();
+        ret = std::move(_bytestream);
+    } else {
+        ret = std::make_unique<std::vector<uint8_t>>(size());
+        uint8_t* out = ret->data();
+        for (const Piece& piece : pieces()) {
+            memcpy(out, piece.data, piece.size);
+            out += piece.size;
+        }
+    }
+
     _bytestream = std::make_unique<std::vector<uint8_t>>();
+    _refs.clear();
+    _refBytes = 0;
     return ret;
-}
\ No newline at end of file
+}
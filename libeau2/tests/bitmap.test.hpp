@@ -0,0 +1,88 @@
+/**
+ * @file bitmap.test.hpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+
+#include "bitmap.hpp"
+#include "column.hpp"
+#include "payload.hpp"
+#include "serializer.hpp"
+
+namespace {
+
+// test setting, counting and resizing bits across words
+TEST(BitmapTest, set_count_resize) {
+    Bitmap bits(130);
+    EXPECT_EQ(3u, bits.wordCount());
+    EXPECT_EQ(0u, bits.count());
+
+    bits.set(0, true);
+    bits.set(64, true);
+    bits.set(129, true);
+    bits.set(129, false);
+    bits.push_back(true);
+    EXPECT_EQ(131u, bits.size());
+    EXPECT_EQ(3u, bits.count());
+    EXPECT_TRUE(bits.get(130));
+    EXPECT_FALSE(bits.get(129));
+
+    bits.resize(200, true);
+    EXPECT_EQ(3u + 69u, bits.count());
+    bits.resize(65);
+    EXPECT_EQ(2u, bits.count());
+    bits.resize(70);
+    EXPECT_EQ(2u, bits.count());
+}
+
+// test combining bitmaps word by word
+TEST(BitmapTest, and_or) {
+    Bitmap a(100);
+    Bitmap b(100);
+    for (size_t ii = 0; ii < 100; ii++) {
+        a.set(ii, ii % 2 == 0);
+        b.set(ii, ii % 3 == 0);
+    }
+
+    EXPECT_EQ(17u, (a & b).count());
+    EXPECT_EQ(67u, (a | b).count());
+    EXPECT_THROW(a &= Bitmap(99), std::invalid_argument);
+}
+
+// test that bool columns round trip packed
+TEST(BoolColumnTest, serialize) {
+    auto col = std::make_shared<Column<bool>>();
+    for (size_t ii = 0; ii < 1001; ii++) col->push_back(ii % 7 == 0);
+    EXPECT_EQ(143u, col->count());
+
+    Payload p;
+    Serializer ss;
+    ASSERT_TRUE(p.add<bool>(col));
+    p.serialize(ss);
+
+    auto bytes = ss.generate();
+    EXPECT_EQ(2 * Serial::PAYLOAD_HDR_SIZE + sizeof(uint64_t) + 126,
+              bytes->size());
+
+    Payload p2;
+    p2.deserialize(bytes->begin(), bytes->end());
+    ColPtr<bool> col2 = p2.asColumn<bool>();
+    ASSERT_EQ(1001u, col2->size());
+    for (size_t ii = 0; ii < 1001; ii++) EXPECT_EQ(col->get(ii), col2->get(ii));
+
+    col2->andWith(Column<bool>(Bitmap(1001, true)));
+    EXPECT_EQ(143u, col2->count());
+    col2->orWith(Column<bool>(Bitmap(1001, true)));
+    EXPECT_EQ(1001u, col2->count());
+}
+
+}  // namespace
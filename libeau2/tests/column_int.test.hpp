@@ -10,6 +10,7 @@
 #include <gtest/gtest.h>
 
 #include <cstdlib>
+#include <vector>
 
 #include "column.hpp"
 
@@ -397,4 +398,44 @@ TEST_F(IntColumnVaMany, set_many) {
     EXPECT_EQ(41, ic->get(100000));
 }
 
+// test that chunks are a power of two items and fill a whole chunk of memory
+TEST(ChunkTest, sizes) {
+    EXPECT_EQ(0u, Chunk<int>::size() & (Chunk<int>::size() - 1));
+    EXPECT_EQ(CHUNK_BYTES, Chunk<int>::bytes());
+    EXPECT_EQ(CHUNK_BYTES, Chunk<double>::bytes());
+    EXPECT_EQ(CHUNK_BYTES / sizeof(double), Chunk<double>::size());
+    EXPECT_EQ(0u, Chunk<ExtString>::bytes() % CACHE_LINE_SIZE);
+}
+
+// test values on either side of a chunk boundary
+TEST_F(IntColumnEmpty, chunk_boundary) {
+    AddSequential(3 * Chunk<int>::size() + 1);
+
+    for (size_t i = 1; i <= 3; i++) {
+        size_t boundary = i * Chunk<int>::size();
+        EXPECT_EQ(boundary - 1, ic->get(boundary - 1));
+        EXPECT_EQ(boundary, ic->get(boundary));
+    }
+
+    ic->set(Chunk<int>::size(), -1);
+    EXPECT_EQ(-1, ic->get(Chunk<int>::size()));
+    EXPECT_EQ(Chunk<int>::size() - 1, ic->get(Chunk<int>::size() - 1));
+}
+
+// test appending an array across chunk boundaries
+TEST_F(IntColumnEmpty, append_array) {
+    std::vector<int> vals(2 * Chunk<int>::size() + 3);
+    for (size_t i = 0; i < vals.size(); i++) vals[i] = i;
+
+    ic->push_back(-1);
+    ic->append(vals.data(), vals.size());
+
+    ASSERT_EQ(vals.size() + 1, ic->size());
+    EXPECT_EQ(-1, ic->get(0));
+    EXPECT_EQ(0, ic->get(1));
+    EXPECT_EQ(Chunk<int>::size() - 1, ic->get(Chunk<int>::size()));
+    EXPECT_EQ(vals.back(), ic->get(vals.size()));
+    EXPECT_FALSE(ic->isMissing(vals.size()));
+}
+
 }  // namespace
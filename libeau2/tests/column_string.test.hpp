@@ -0,0 +1,260 @@
+/**
+ * @file column_string.test.hpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "column.hpp"
+#include "dataframe.hpp"
+#include "payload.hpp"
+#include "rowbatch.hpp"
+#include "rower.hpp"
+#include "serializer.hpp"
+
+namespace {
+
+// test appending and reading back strings
+TEST(StringColumnTest, push_back_get) {
+    Column<ExtString> col;
+    col.push_back(std::make_shared<std::string>("abc"));
+    col.push_back("");
+    col.push_back(std::string_view("defg"));
+    col.push_back(ExtString());
+
+    ASSERT_EQ(4u, col.size());
+    EXPECT_EQ("abc", col.get(0));
+    EXPECT_EQ("", col.get(1));
+    EXPECT_EQ("defg", col.get(2));
+    EXPECT_EQ("", col.get(3));
+    EXPECT_EQ("abc, , defg, ", col.str());
+    EXPECT_EQ(4u + 1u + 5u + 1u, col.arenaBytes());
+}
+
+// test that interned columns store repeated values once
+TEST(StringColumnTest, interned) {
+    Column<ExtString> plain;
+    Column<ExtString> interned(true);
+    for (size_t ii = 0; ii < 1000; ii++) {
+        const char* lang = ii % 3 ? "C++" : "Rust";
+        plain.push_back(lang);
+        interned.push_back(lang);
+    }
+
+    EXPECT_TRUE(interned.interned());
+    EXPECT_EQ(4u + 5u, interned.arenaBytes());
+    EXPECT_LT(interned.arenaBytes() * 100, plain.arenaBytes());
+    for (size_t ii = 0; ii < 1000; ii++) {
+        EXPECT_EQ(plain.get(ii), interned.get(ii));
+    }
+}
+
+// test that set and packed appends keep every value readable
+TEST(StringColumnTest, set_packed) {
+    Column<ExtString> col{std::make_shared<std::string>("a"),
+                          std::make_shared<std::string>("b")};
+    col.set(0, "longer");
+
+    const char packed[] = "x\0yz\0tail";
+    col.pushPacked(packed, sizeof(packed) - 1);
+
+    ASSERT_EQ(4u, col.size());
+    EXPECT_EQ("longer", col.get(0));
+    EXPECT_EQ("b", col.get(1));
+    EXPECT_EQ("x", col.get(2));
+    EXPECT_EQ("yz", col.get(3));
+}
+
+// test serializing columns with and without a dense arena
+TEST(StringColumnTest, serialize) {
+    auto dense = std::make_shared<Column<ExtString>>();
+    auto sparse = std::make_shared<Column<ExtString>>(true);
+    for (const char* val : {"abc", "de", "abc"}) {
+        dense->push_back(val);
+        sparse->push_back(val);
+    }
+
+    for (auto& col : {dense, sparse}) {
+        Payload p;
+        Serializer ss;
+        ASSERT_TRUE(p.add<ExtString>(col));
+        p.serialize(ss);
+
+        auto bytes = ss.generate();
+        EXPECT_EQ(2 * Serial::PAYLOAD_HDR_SIZE + 4 + 3 + 4, bytes->size());
+
+        Payload p2;
+        p2.deserialize(bytes->begin(), bytes->end());
+        ColPtr<ExtString> col2 = p2.asColumn<ExtString>();
+        ASSERT_EQ(3u, col2->size());
+        EXPECT_EQ("abc", col2->get(0));
+        EXPECT_EQ("de", col2->get(1));
+        EXPECT_EQ("abc", col2->get(2));
+    }
+}
+
+// test that encoded columns sharing a dictionary share codes
+TEST(DictColumnTest, shared_dict) {
+    auto dict = std::make_shared<StringDict>();
+    Column<ExtString> langs(dict);
+    Column<ExtString> others(dict);
+    langs.push_back("C++");
+    langs.push_back("Go");
+    langs.push_back("C++");
+    others.push_back(std::make_shared<std::string>("Go"));
+    others.set(0, "C++");
+
+    ASSERT_EQ(3u, langs.size());
+    EXPECT_EQ(2u, dict->size());
+    EXPECT_EQ("Go", langs.get(1));
+    EXPECT_EQ(langs.code(0), langs.code(2));
+    EXPECT_EQ(langs.code(0), others.code(0));
+    EXPECT_NE(langs.code(0), langs.code(1));
+    EXPECT_EQ(langs.code(1), dict->find("Go"));
+    EXPECT_EQ(StringDict::NOT_FOUND, dict->find("Rust"));
+    EXPECT_EQ(0u, langs.arenaBytes());
+}
+
+// test that encoded columns round trip as the dictionary plus codes
+TEST(DictColumnTest, serialize) {
+    auto col = std::make_shared<Column<ExtString>>(
+        std::make_shared<StringDict>());
+    for (size_t ii = 0; ii < 1000; ii++) col->push_back(ii % 2 ? "ab" : "c");
+
+    Payload p;
+    Serializer ss;
+    ASSERT_TRUE(p.add<ExtString>(col));
+    p.serialize(ss);
+
+    auto bytes = ss.generate();
+    EXPECT_EQ(2 * Serial::PAYLOAD_HDR_SIZE + 2 * sizeof(uint64_t) + 3 + 2 +
+                  1000 * sizeof(uint32_t),
+              bytes->size());
+
+    Payload p2;
+    p2.deserialize(bytes->begin(), bytes->end());
+    ColPtr<ExtString> col2 = p2.asColumn<ExtString>();
+    ASSERT_TRUE(col2->dict());
+    ASSERT_EQ(1000u, col2->size());
+    EXPECT_EQ(2u, col2->dict()->size());
+    for (size_t ii = 0; ii < 1000; ii++) {
+        EXPECT_EQ(col->get(ii), col2->get(ii));
+    }
+}
+
+// test that columns sharing a dictionary send it once per DataFrame
+TEST(DictColumnTest, serialize_shared_dict) {
+    auto dict = std::make_shared<StringDict>();
+    auto langs = std::make_shared<Column<ExtString>>(dict);
+    auto others = std::make_shared<Column<ExtString>>(dict);
+    for (size_t ii = 0; ii < 10; ii++) {
+        langs->push_back(ii % 2 ? "Go" : "C++");
+        others->push_back(ii % 3 ? "C++" : "Go");
+    }
+
+    auto df = std::make_shared<DataFrame>();
+    df->addCol(langs);
+    df->addCol(others);
+
+    Payload p;
+    Serializer ss;
+    ASSERT_TRUE(p.add(df));
+    p.serialize(ss);
+
+    // each column is its own Payload wrapping the data's, the first column
+    // carries the dictionary "C++\0Go\0" and its size
+    auto bytes = ss.generate();
+    EXPECT_EQ(5 * Serial::PAYLOAD_HDR_SIZE + 2 * sizeof(uint64_t) +
+                  sizeof(uint64_t) + 7 + 20 * sizeof(uint32_t),
+              bytes->size());
+
+    Payload p2;
+    p2.deserialize(bytes->begin(), bytes->end());
+    DFPtr df2 = p2.asDataFrame();
+    ASSERT_EQ(2u, df2->ncols());
+    ASSERT_EQ(10u, df2->nrows());
+    EXPECT_EQ(df2->column<ExtString>(0).column().dict(),
+              df2->column<ExtString>(1).column().dict());
+    for (size_t ii = 0; ii < 10; ii++) {
+        EXPECT_EQ(langs->get(ii), df2->getString(0, ii));
+        EXPECT_EQ(others->get(ii), df2->getString(1, ii));
+    }
+}
+
+// test that a dictionary column naming an unsent dictionary is rejected
+TEST(DictColumnTest, deserialize_unknown_dict) {
+    auto col = std::make_shared<Column<ExtString>>(
+        std::make_shared<StringDict>());
+    col->push_back("ab");
+
+    Payload p;
+    Serializer ss;
+    ASSERT_TRUE(p.add<ExtString>(col));
+    p.serialize(ss);
+
+    // point the column at a dictionary that was never sent
+    auto bytes = ss.generate();
+    (*bytes)[2 * Serial::PAYLOAD_HDR_SIZE] = 1;
+
+    Payload p2;
+    p2.deserialize(bytes->begin(), bytes->end());
+    EXPECT_EQ(nullptr, p2.asColumn<ExtString>());
+}
+
+// Keeps rows whose string column has the given code
+class CodeEquals : public Rower {
+   public:
+    uint32_t code;
+
+    explicit CodeEquals(uint32_t code) : code(code) {}
+
+    bool accept(Row& r) override { return false; }
+
+    void acceptBatch(RowBatch& batch) override {
+        Block<uint32_t> codes = batch.codes(0);
+        for (size_t ii = 0; ii < codes.size(); ii++) {
+            batch.selected()[ii] = codes[ii] == code;
+        }
+    }
+
+    void join_delete(Rower* other) override { delete other; }
+
+    Rower* clone() override { return new CodeEquals(code); }
+};
+
+// test filtering on codes keeps the result encoded
+TEST(DictColumnTest, filter_codes) {
+    auto dict = std::make_shared<StringDict>();
+    auto col = std::make_shared<Column<ExtString>>(dict);
+    for (size_t ii = 0; ii < 3 * Chunk<uint64_t>::size(); ii++) {
+        col->push_back(ii % 3 ? "Java" : "Rust");
+    }
+
+    DataFrame df;
+    df.addCol(col);
+
+    CodeEquals rust(dict->find("Rust"));
+    DFPtr res = df.filter(rust);
+
+    ASSERT_EQ(Chunk<uint64_t>::size(), res->nrows());
+    EXPECT_EQ("Rust", res->getString(0, 7));
+    EXPECT_EQ(dict, res->column<ExtString>(0).column().dict());
+
+    // plain string columns have no codes
+    DataFrame plain;
+    plain.addCol(std::make_shared<Column<ExtString>>(
+        std::initializer_list<ExtString>{std::make_shared<std::string>("x")}));
+    RowBatch batch(plain, 0, 1);
+    EXPECT_THROW(batch.codes(0), std::runtime_error);
+}
+
+}  // namespace
@@ -0,0 +1,159 @@
+/**
+ * @file columnfile.test.hpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "column.hpp"
+#include "columnfile.hpp"
+#include "dataframe.hpp"
+
+namespace {
+
+// test writing a DataFrame spanning several chunks and mapping it back
+TEST(ColumnFileTest, round_trip) {
+    const char* filename = "columnfile_test.eau2";
+    const size_t rows = 40000;
+
+    auto ints = std::make_shared<Column<int>>();
+    auto doubles = std::make_shared<Column<double>>();
+    auto bools = std::make_shared<Column<bool>>();
+    auto strings = std::make_shared<Column<ExtString>>(true);
+    for (size_t ii = 0; ii < rows; ii++) {
+        ints->push_back(static_cast<int>(ii) - 100);
+        if (ii % 1000 == 3) {
+            doubles->pushMissing();
+        } else {
+            doubles->push_back(ii * 0.5);
+        }
+        bools->push_back(ii % 3 == 0);
+        strings->push_back("item " + std::to_string(ii % 7));
+    }
+
+    DataFrame df;
+    df.addCol(ints);
+    df.addCol(doubles);
+    df.addCol(bools);
+    df.addCol(strings);
+    ASSERT_TRUE(ColumnFile::write(df, filename));
+
+    DFPtr loaded;
+    {
+        ColumnFile file(filename);
+        ASSERT_TRUE(file.isOpen());
+        EXPECT_EQ(rows, file.nrows());
+        EXPECT_EQ(4u, file.ncols());
+        EXPECT_EQ('S', file.colType(3));
+
+        double min, max;
+        ASSERT_TRUE(file.chunkRange(0, 0, min, max));
+        EXPECT_EQ(-100.0, min);
+        EXPECT_EQ(Chunk<int>::size() - 101.0, max);
+        ASSERT_TRUE(file.chunkRange(0, 2, min, max));
+        EXPECT_EQ(rows - 101.0, max);
+        EXPECT_FALSE(file.chunkRange(0, 3, min, max));
+        EXPECT_FALSE(file.chunkRange(2, 0, min, max));
+
+        loaded = file.dataFrame();
+    }
+
+    // the DataFrame keeps the mapping alive
+    ASSERT_NE(nullptr, loaded);
+    ASSERT_EQ(rows, loaded->nrows());
+    for (size_t ii = 0; ii < rows; ii += 999) {
+        ASSERT_EQ(ints->get(ii), loaded->getInt(0, ii));
+        ASSERT_EQ(doubles->get(ii), loaded->getDouble(1, ii));
+        ASSERT_EQ(bools->get(ii), loaded->getBool(2, ii));
+        ASSERT_EQ(strings->get(ii), loaded->getString(3, ii));
+    }
+    EXPECT_TRUE(loaded->isMissing(1, 1003));
+    EXPECT_FALSE(loaded->isMissing(1, 1004));
+    EXPECT_TRUE(loaded->getSchema().isNullable(1));
+    EXPECT_FALSE(loaded->getSchema().isNullable(0));
+
+    // changes stay in memory
+    loaded->set(0, 5, 42);
+    EXPECT_EQ(42, loaded->getInt(0, 5));
+    EXPECT_EQ(-95, ColumnFile(filename).dataFrame()->getInt(0, 5));
+
+    remove(filename);
+}
+
+// test files that aren't column files
+TEST(ColumnFileTest, invalid) {
+    EXPECT_FALSE(ColumnFile("no_such_file.eau2").isOpen());
+
+    const char* filename = "columnfile_bad.eau2";
+    FILE* file = fopen(filename, "w");
+    ASSERT_NE(nullptr, file);
+    fprintf(file, "<1> <2> <3>\n<4> <5> <6>\n<7> <8> <9>\n");
+    fclose(file);
+
+    ColumnFile bad(filename);
+    EXPECT_FALSE(bad.isOpen());
+    EXPECT_EQ(nullptr, bad.dataFrame());
+    remove(filename);
+}
+
+// test a row count that the file couldn't hold
+TEST(ColumnFileTest, bad_rows) {
+    const char* filename = "columnfile_rows.eau2";
+    auto ints = std::make_shared<Column<int>>();
+    ints->push_back(1);
+    DataFrame df;
+    df.addCol(ints);
+    ASSERT_TRUE(ColumnFile::write(df, filename));
+    ASSERT_TRUE(ColumnFile(filename).isOpen());
+
+    // large enough that the number of chunks wraps around to 0
+    FILE* file = fopen(filename, "r+b");
+    ASSERT_NE(nullptr, file);
+    uint64_t rows = std::numeric_limits<uint64_t>::max();
+    fseek(file, offsetof(ColumnFile::Header, rows), SEEK_SET);
+    fwrite(&rows, sizeof(rows), 1, file);
+    fclose(file);
+
+    ColumnFile bad(filename);
+    EXPECT_FALSE(bad.isOpen());
+    EXPECT_EQ(nullptr, bad.dataFrame());
+    remove(filename);
+}
+
+// test a string offset past the end of the arena
+TEST(ColumnFileTest, bad_offset) {
+    const char* filename = "columnfile_offset.eau2";
+    auto strings = std::make_shared<Column<ExtString>>();
+    strings->push_back("a");
+    strings->push_back("b");
+    DataFrame df;
+    df.addCol(strings);
+    ASSERT_TRUE(ColumnFile::write(df, filename));
+    ASSERT_TRUE(ColumnFile(filename).isOpen());
+
+    FILE* file = fopen(filename, "r+b");
+    ASSERT_NE(nullptr, file);
+    ColumnFile::ColumnHeader column;
+    fseek(file, sizeof(ColumnFile::Header), SEEK_SET);
+    ASSERT_EQ(1u, fread(&column, sizeof(column), 1, file));
+    uint64_t offset = column.arenaBytes;
+    fseek(file, column.data + sizeof(uint64_t), SEEK_SET);
+    fwrite(&offset, sizeof(offset), 1, file);
+    fclose(file);
+
+    EXPECT_FALSE(ColumnFile(filename).isOpen());
+    remove(filename);
+}
+
+}  // namespace
@@ -37,10 +37,11 @@ TEST(DataFrameTest, fromColumn) {
     KVStore kv(net, "address", "port");
     Key k("dataf", 0);
 
-    ne::ColumnSet set(3);
+    ne::ColumnSet set(4);
     set.initializeColumn(0, ne::ColumnType::BOOL);
     set.initializeColumn(1, ne::ColumnType::INTEGER);
     set.initializeColumn(2, ne::ColumnType::STRING);
+    set.initializeColumn(3, ne::ColumnType::FLOAT);
 
     ne::BoolColumn* col1 = dynamic_cast<ne::BoolColumn*>(set.getColumn(0));
     ne::IntegerColumn* col2 =
@@ -60,6 +61,11 @@ dynamic_cast<ne::StringColumn*>(set.getColumn(2));
     col3->append(cwc_strdup("goodbye"));
     col3->append(cwc_strdup("yes"));
 
+    ne::FloatColumn* col4 = dynamic_cast<ne::FloatColumn*>(set.getColumn(3));
+    col4->append(1.5);
+    col4->appendMissing();
+    col4->append(-2.5);
+
     DataFrame::fromColumnSet(&k, &kv, &set);
 
     // net.send(std::make_shared<Kill>(0, 0));
@@ -68,5 +74,14 @@ dynamic_cast<ne::StringColumn*>(set.getColumn(2));
 
     ASSERT_EQ(true, df->getBool(0, 0));
     ASSERT_EQ(-5, df->getInt(1, 1));
-    ASSERT_STREQ("yes", df->getString(2, 2)->c_str());
+    ASSERT_EQ("yes", df->getString(2, 2));
+
+    // floats are loaded as doubles and missing entries stay in place
+    ASSERT_EQ('D', df->getSchema().colType(3));
+    ASSERT_EQ(-2.5, df->getDouble(3, 2));
+    ASSERT_TRUE(df->isMissing(3, 1));
+    ASSERT_FALSE(df->isMissing(1, 1));
+
+    // the set's columns are freed once copied
+    ASSERT_EQ(nullptr, set._columns[0]);
 }
@@ -0,0 +1,121 @@
+/**
+ * @file dataframe_fromFile.test.hpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+#include "dataframe.hpp"
+#include "key.hpp"
+#include "kvstore.hpp"
+#include "testutils.hpp"
+
+namespace {
+
+// test loading a SoR file large enough to be sampled and parsed in several
+// segments
+TEST(DataFrameFromFileTest, segments) {
+    const char* filename = "fromfile_test.sor";
+    const size_t rows = 150000;
+
+    FILE* file = fopen(filename, "w");
+    ASSERT_NE(nullptr, file);
+    for (size_t ii = 0; ii < rows; ii++) {
+        // the last column only looks like floats past the first lines
+        if (ii % 1000 == 7) {
+            // missing double and string
+            fprintf(file, "<%zu> <> <1> <> <%zu>\n", ii, ii);
+        } else if (ii < 50000) {
+            fprintf(file, "<%zu> <%zu.5> <%d> <\"row %zu\"> <%zu>\n", ii, ii,
+                    ii % 3 == 0, ii, ii);
+        } else {
+            fprintf(file, "<%zu> <%zu.5> <%d> <\"row %zu\"> <%zu.25>\n", ii,
+                    ii, ii % 3 == 0, ii, ii);
+        }
+    }
+    fclose(file);
+
+    Key key("file", 0);
+    DFPtr df = DataFrame::fromFile(filename, key, nullptr);
+    remove(filename);
+
+    ASSERT_NE(nullptr, df);
+    ASSERT_EQ(rows, df->nrows());
+    ASSERT_EQ(5u, df->ncols());
+    EXPECT_EQ('I', df->getSchema().colType(0));
+    EXPECT_EQ('D', df->getSchema().colType(1));
+    EXPECT_EQ('B', df->getSchema().colType(2));
+    EXPECT_EQ('S', df->getSchema().colType(3));
+    EXPECT_EQ('D', df->getSchema().colType(4));
+
+    // rows stay in file order across segments
+    for (size_t ii = 0; ii < rows; ii += 997) {
+        ASSERT_EQ(static_cast<int>(ii), df->getInt(0, ii));
+    }
+    EXPECT_EQ(149999, df->getInt(0, rows - 1));
+    EXPECT_EQ(123456.5, df->getDouble(1, 123456));
+    EXPECT_TRUE(df->getBool(2, 3));
+    EXPECT_FALSE(df->getBool(2, 4));
+    EXPECT_EQ("row 140000", df->getString(3, 140000));
+    EXPECT_EQ(12.0, df->getDouble(4, 12));
+    EXPECT_EQ(140000.25, df->getDouble(4, 140000));
+
+    EXPECT_TRUE(df->isMissing(1, 140007));
+    EXPECT_TRUE(df->isMissing(3, 7));
+    EXPECT_FALSE(df->isMissing(2, 7));
+    EXPECT_TRUE(df->getSchema().isNullable(3));
+    EXPECT_FALSE(df->getSchema().isNullable(0));
+
+    EXPECT_EQ(nullptr, DataFrame::fromFile("no_such_file.sor", key, nullptr));
+}
+
+// test streaming a SoR file into blocks spread over the store
+TEST(DataFrameFromFileTest, streamFile) {
+    const char* filename = "streamfile_test.sor";
+    const size_t rows = 4500;
+
+    FILE* file = fopen(filename, "w");
+    ASSERT_NE(nullptr, file);
+    for (size_t ii = 0; ii < rows; ii++) {
+        fprintf(file, "<%zu> <\"row %zu\">\n", ii, ii);
+    }
+    fclose(file);
+
+    KVNetMock net;
+    KVStore kv(net, "address", "port");
+    Key key("stream", 1);
+    DFPtr df = DataFrame::streamFile(filename, key, kv, 2, 1000);
+    // the directory is kept on the node loading the file
+    EXPECT_THROW(DataFrame::streamFile(filename, Key("stream", 2), kv, 2, 1000),
+                 std::invalid_argument);
+    remove(filename);
+
+    ASSERT_NE(nullptr, df);
+    EXPECT_EQ(rows, df->nrows());
+    EXPECT_EQ('I', df->getSchema().colType(0));
+    EXPECT_EQ('S', df->getSchema().colType(1));
+    EXPECT_FALSE(df->getSchema().isLocal());
+    EXPECT_EQ(df, kv.waitAndGet(key));
+    EXPECT_EQ("stream_3", df->getString(0, 3));
+
+    // blocks alternate between nodes 1 and 2, the mock hands node 2's back
+    for (size_t ii = 0; ii < 5; ii++) {
+        Key blockKey(("stream_" + std::to_string(ii)).c_str(), 1 + ii % 2);
+        DFPtr block = kv.waitAndGet(blockKey);
+        ASSERT_NE(nullptr, block);
+        EXPECT_EQ(ii < 4 ? 1000u : 500u, block->nrows());
+        EXPECT_EQ(static_cast<int>(ii * 1000), block->getInt(0, 0));
+        EXPECT_EQ("row " + std::to_string(ii * 1000 + block->nrows() - 1),
+                  block->getString(1, block->nrows() - 1));
+    }
+}
+
+}  // namespace
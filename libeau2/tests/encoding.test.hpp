@@ -0,0 +1,225 @@
+/**
+ * @file encoding.test.hpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "column.hpp"
+#include "encoding.hpp"
+#include "payload.hpp"
+#include "serializer.hpp"
+#include "span.hpp"
+
+namespace {
+
+// Checks every way of reading the chunk against the items it was made from
+template <typename T>
+void expectItems(const EncodedChunk<T>& chunk, const std::vector<T>& items) {
+    ASSERT_EQ(items.size(), chunk.size());
+
+    std::vector<T> decoded(items.size());
+    chunk.decodeTo(decoded.data());
+    EXPECT_EQ(items, decoded);
+
+    for (size_t ii = 0; ii < items.size(); ii += 37) {
+        ASSERT_EQ(items[ii], chunk.get(ii));
+    }
+    EXPECT_EQ(items.back(), chunk.get(items.size() - 1));
+
+    EncodedChunk<T> copy;
+    ASSERT_TRUE(EncodedChunk<T>::decode(chunk.encoding(), chunk.size(),
+                                        chunk.data(), chunk.bytes(), copy));
+    EXPECT_EQ(items.back(), copy.get(items.size() - 1));
+}
+
+// test that each kind of data gets the encoding it compresses best with
+TEST(EncodingTest, choose_encoding) {
+    const size_t size = Chunk<int>::size();
+    std::vector<int> sorted, runs, small, noise;
+    uint64_t state = 12345;
+    for (size_t ii = 0; ii < size; ii++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        sorted.push_back(-5000 + 3 * ii + (state >> 62));
+        runs.push_back(ii / 1000 - 7);
+        small.push_back(-100000 + (state >> 58));
+        noise.push_back(static_cast<int>(state >> 32));
+    }
+
+    auto chunk = EncodedChunk<int>::encode(sorted.data(), size);
+    EXPECT_EQ(IntEncoding::Delta, chunk.encoding());
+    EXPECT_LT(chunk.bytes(), size * sizeof(int) / 8);
+    expectItems(chunk, sorted);
+
+    chunk = EncodedChunk<int>::encode(runs.data(), size);
+    EXPECT_EQ(IntEncoding::RunLength, chunk.encoding());
+    expectItems(chunk, runs);
+
+    chunk = EncodedChunk<int>::encode(small.data(), size);
+    EXPECT_EQ(IntEncoding::FrameOfReference, chunk.encoding());
+    EXPECT_LT(chunk.bytes(), size * sizeof(int) / 4);
+    expectItems(chunk, small);
+
+    chunk = EncodedChunk<int>::encode(noise.data(), size);
+    EXPECT_EQ(IntEncoding::Plain, chunk.encoding());
+    expectItems(chunk, noise);
+}
+
+// test values at the limits of int64_t, whose differences overflow
+TEST(EncodingTest, int64_limits) {
+    std::vector<int64_t> items;
+    for (size_t ii = 0; ii < 1000; ii++) {
+        items.push_back(ii % 2 ? INT64_MAX - ii % 4 : INT64_MIN + ii % 3);
+    }
+
+    auto chunk = EncodedChunk<int64_t>::encode(items.data(), items.size());
+    EXPECT_NE(IntEncoding::Delta, chunk.encoding());
+    expectItems(chunk, items);
+
+    std::vector<int64_t> wide{INT64_MIN, 0, INT64_MAX, 5, INT64_MIN};
+    chunk = EncodedChunk<int64_t>::encode(wide.data(), wide.size());
+    expectItems(chunk, wide);
+
+    int64_t sum = 0;
+    chunk.forEach([&sum](int64_t item) { sum += item == INT64_MAX; });
+    EXPECT_EQ(1, sum);
+}
+
+// test that bytes that don't match their encoding are rejected
+TEST(EncodingTest, decode_invalid) {
+    std::vector<int> items{1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2};
+    auto chunk = EncodedChunk<int>::encode(items.data(), items.size());
+    ASSERT_EQ(IntEncoding::RunLength, chunk.encoding());
+
+    EncodedChunk<int> copy;
+    EXPECT_FALSE(EncodedChunk<int>::decode(chunk.encoding(), items.size() + 1,
+                                           chunk.data(), chunk.bytes(), copy));
+    EXPECT_FALSE(EncodedChunk<int>::decode(chunk.encoding(), items.size(),
+                                           chunk.data(), chunk.bytes() - 1,
+                                           copy));
+    EXPECT_FALSE(EncodedChunk<int>::decode(IntEncoding::Delta, items.size(),
+                                           chunk.data(), chunk.bytes(), copy));
+    EXPECT_FALSE(EncodedChunk<int>::decode(static_cast<IntEncoding>(9),
+                                           items.size(), chunk.data(),
+                                           chunk.bytes(), copy));
+    // items without a single run
+    EXPECT_FALSE(EncodedChunk<int>::decode(chunk.encoding(), items.size(),
+                                           chunk.data(), 0, copy));
+}
+
+// test sealing a column, reading it and changing it afterwards
+TEST(EncodingTest, seal_column) {
+    auto col = std::make_shared<Column<int>>();
+    const size_t size = 3 * Chunk<int>::size() + 100;
+    for (size_t ii = 0; ii < size; ii++) col->push_back(ii / 10);
+    col->setMissing(7);
+
+    size_t plainBytes = col->itemBytes();
+    col->seal();
+    ASSERT_TRUE(col->sealed());
+    EXPECT_LT(col->itemBytes(), plainBytes / 10);
+    EXPECT_EQ(size, col->size());
+    EXPECT_TRUE(col->isMissing(7));
+    EXPECT_EQ(4000, col->get(40005));
+
+    int64_t sum = 0;
+    col->forEach([&sum](int item) { sum += item; });
+    int64_t expected = 0;
+    for (size_t ii = 0; ii < size; ii++) expected += ii / 10;
+    EXPECT_EQ(expected, sum);
+
+    sum = 0;
+    for (const Block<int>& block : ColumnSpan<int>(col)) {
+        for (int item : block) sum += item;
+    }
+    EXPECT_EQ(expected, sum);
+    EXPECT_EQ(1638, col->slice(16380, 4)[0]);
+
+    col->set(3, 42);
+    EXPECT_FALSE(col->sealed());
+    EXPECT_EQ(42, col->get(3));
+    EXPECT_EQ(4000, col->get(40005));
+    col->push_back(-1);
+    EXPECT_EQ(-1, col->get(size));
+
+    Column<double> doubles{1.0, 2.0};
+    doubles.seal();
+    EXPECT_FALSE(doubles.sealed());
+}
+
+// test that a sealed column encodes chunks as appending fills them
+TEST(EncodingTest, seal_as_filled) {
+    auto col = std::make_shared<Column<int>>();
+    col->seal();
+    const size_t size = 3 * Chunk<int>::size() + 100;
+    for (size_t ii = 0; ii < size; ii++) col->push_back(ii / 10);
+
+    // only the partial last chunk is held plain
+    ASSERT_TRUE(col->sealed());
+    EXPECT_EQ(4u, col->blocks());
+    EXPECT_LT(col->itemBytes(), 2 * Chunk<int>::bytes());
+    EXPECT_EQ(IntEncoding::Delta, col->encodedChunk(2).encoding());
+
+    std::vector<int> more(2 * Chunk<int>::size(), 7);
+    col->append(more.data(), more.size());
+    col->seal();
+    EXPECT_EQ(size + more.size(), col->size());
+    EXPECT_EQ(6u, col->blocks());
+    EXPECT_LT(col->itemBytes(), Chunk<int>::bytes() / 4);
+    EXPECT_EQ(4000, col->get(40005));
+    EXPECT_EQ(7, col->get(size));
+    EXPECT_EQ(7, col->get(col->size() - 1));
+
+    // Blocks of encoded chunks hold their items
+    Block<int> block = col->block(1);
+    col.reset();
+    EXPECT_EQ(Chunk<int>::size(), block.size());
+    EXPECT_EQ(static_cast<int>(Chunk<int>::size() / 10), block[0]);
+}
+
+// test that compressible sealed int columns are sent encoded and stay sealed
+TEST(EncodingTest, payload) {
+    auto col = std::make_shared<Column<int>>();
+    const size_t size = 50000;
+    for (size_t ii = 0; ii < size; ii++) col->push_back(ii);
+    col->setMissing(10);
+
+    // unsealed columns are sent as they are
+    {
+        Payload p;
+        ASSERT_TRUE(p.add<int>(col));
+        Serializer ss;
+        p.serialize(ss);
+        EXPECT_GT(ss.generate()->size(), size * sizeof(int));
+    }
+
+    col->seal();
+    Payload p;
+    ASSERT_TRUE(p.add<int>(col));
+    Serializer ss;
+    p.serialize(ss);
+    auto bytes = ss.generate();
+    EXPECT_LT(bytes->size(), size * sizeof(int) / 10);
+
+    Payload p2;
+    p2.deserialize(bytes->begin(), bytes->end());
+    ColPtr<int> col2 = p2.asColumn<int>();
+    ASSERT_NE(nullptr, col2);
+    ASSERT_EQ(size, col2->size());
+    EXPECT_TRUE(col2->sealed());
+    EXPECT_TRUE(col2->isMissing(10));
+    for (size_t ii = 0; ii < size; ii += 777) {
+        ASSERT_EQ(static_cast<int>(ii), col2->get(ii));
+    }
+}
+
+}  // namespace
@@ -0,0 +1,74 @@
+/**
+ * @file executor.test.hpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+
+#include "executor.hpp"
+
+namespace {
+
+// test that every task of a group runs before wait returns
+TEST(ExecutorTest, run_all) {
+    Executor exec(3);
+    std::atomic<long> sum{0};
+
+    TaskGroup group(exec);
+    for (long ii = 0; ii < 1000; ii++) {
+        group.run([&sum, ii] { sum += ii; });
+    }
+    group.wait();
+
+    EXPECT_EQ(3u, exec.size());
+    EXPECT_EQ(999 * 1000 / 2, sum);
+}
+
+// test tasks waiting on groups of their own, with a single worker
+TEST(ExecutorTest, nested_groups) {
+    Executor exec(1);
+    std::atomic<int> count{0};
+
+    TaskGroup outer(exec);
+    for (int ii = 0; ii < 4; ii++) {
+        outer.run([&exec, &count] {
+            EXPECT_EQ(0u, exec.workerIdx());
+
+            TaskGroup inner(exec);
+            for (int jj = 0; jj < 8; jj++) inner.run([&count] { count++; });
+            inner.wait();
+        });
+    }
+    outer.wait();
+
+    EXPECT_EQ(32, count);
+}
+
+// test that task exceptions reach the waiter
+TEST(ExecutorTest, exception) {
+    Executor exec(2);
+    TaskGroup group(exec);
+    group.run([] { throw std::runtime_error("task failed"); });
+    group.run([] {});
+
+    ASSERT_THROW(group.wait(), std::runtime_error);
+    ASSERT_NO_THROW(group.wait());
+}
+
+// test that threads outside the pool are not workers
+TEST(ExecutorTest, outside_pool) {
+    Executor exec(2);
+    EXPECT_EQ(Executor::NOT_A_WORKER, exec.workerIdx());
+    EXPECT_FALSE(exec.tryRunOne());
+    EXPECT_LE(1u, Executor::global().size());
+}
+
+}  // namespace
@@ -0,0 +1,110 @@
+/**
+ * @file frame.test.hpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "frame.hpp"
+#include "serial.hpp"
+
+namespace {
+
+// Reads the bytes of a message from at on
+Serial::Reader frameReader(const std::vector<uint8_t>& message, size_t at) {
+    return [&message, at](void* buf, size_t bytes) mutable {
+        memcpy(buf, message.data() + at, bytes);
+        at += bytes;
+        return 0;
+    };
+}
+
+// Frames pushed out of order, as from several connections, are read in order
+TEST(FrameStreamTest, reorder) {
+    std::vector<uint8_t> message(1000);
+    for (size_t ii = 0; ii < message.size(); ii++) message[ii] = ii * 7;
+
+    FrameStream stream(message.size());
+    std::vector<uint8_t> read(message.size());
+    std::thread reader([&] {
+        EXPECT_EQ(0, stream.read(read.data(), 10));
+        EXPECT_EQ(0, stream.read(read.data() + 10, read.size() - 10));
+        stream.detach();
+    });
+
+    size_t offsets[] = {600, 0, 300, 900};
+    size_t lengths[] = {300, 300, 300, 100};
+    for (size_t ii = 0; ii < 4; ii++) {
+        EXPECT_FALSE(stream.complete());
+        EXPECT_EQ(0, stream.push(offsets[ii], lengths[ii],
+                                 frameReader(message, offsets[ii])));
+    }
+    EXPECT_TRUE(stream.complete());
+    reader.join();
+
+    EXPECT_EQ(message, read);
+}
+
+// Frames are kept without waiting for a reader, until it reads them or stops
+// reading
+TEST(FrameStreamTest, buffered) {
+    std::vector<uint8_t> message(1000);
+    for (size_t ii = 0; ii < message.size(); ii++) message[ii] = ii * 3;
+
+    FrameStream stream(message.size());
+    for (size_t offset = 0; offset < 750; offset += 250) {
+        EXPECT_EQ(0, stream.push(offset, 250, frameReader(message, offset)));
+    }
+    EXPECT_EQ(750u, stream.buffered());
+
+    std::vector<uint8_t> read(message.size());
+    EXPECT_EQ(0, stream.read(read.data(), 300));
+    EXPECT_EQ(500u, stream.buffered());
+    EXPECT_EQ(0, stream.push(750, 250, frameReader(message, 750)));
+    EXPECT_EQ(0, stream.read(read.data() + 300, read.size() - 300));
+    EXPECT_EQ(0u, stream.buffered());
+    EXPECT_EQ(message, read);
+
+    FrameStream dropped(message.size());
+    EXPECT_EQ(0, dropped.push(0, 250, frameReader(message, 0)));
+    dropped.detach();
+    EXPECT_EQ(0u, dropped.buffered());
+    EXPECT_EQ(0, dropped.push(250, 250, frameReader(message, 250)));
+    EXPECT_EQ(0u, dropped.buffered());
+}
+
+// Reads waiting for frames that never come fail once the stream is closed,
+// and frames nobody reads any more are skipped
+TEST(FrameStreamTest, close) {
+    std::vector<uint8_t> message(100, 1);
+    FrameStream stream(message.size());
+    EXPECT_EQ(0, stream.push(0, 50, frameReader(message, 0)));
+
+    uint8_t buf[100];
+    EXPECT_EQ(0, stream.read(buf, 50));
+    EXPECT_NE(0, stream.read(buf, 101 - 50));
+
+    std::thread closer([&] { stream.close(); });
+    EXPECT_NE(0, stream.read(buf, 50));
+    closer.join();
+    stream.detach();
+
+    size_t skipped = 0;
+    EXPECT_EQ(0, stream.push(50, 50, [&](void*, size_t bytes) {
+                  skipped += bytes;
+                  return 0;
+              }));
+    EXPECT_EQ(50u, skipped);
+}
+
+}  // namespace
@@ -0,0 +1,108 @@
+/**
+ * @file kvnetLocal.test.hpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+
+#include "dataframe.hpp"
+#include "key.hpp"
+#include "kvnetLocal.hpp"
+#include "kvstore.hpp"
+#include "put.hpp"
+
+namespace {
+
+// The message received is the one sent
+TEST(KVNetLocalTest, handoff) {
+    KVNetLocal::Cluster cluster(2);
+    KVNetLocal net1(cluster);
+    KVNetLocal net2(cluster);
+
+    EXPECT_EQ(1u, net1.registerNode("address", "port"));
+    EXPECT_EQ(2u, net2.registerNode("address", "port"));
+    EXPECT_TRUE(net1.ready());
+
+    auto df = std::make_shared<DataFrame>();
+    auto put = std::make_shared<Put>(1, Key("df", 2), df);
+    net1.send(put);
+
+    EXPECT_EQ(nullptr, net1.receive());
+    std::shared_ptr<Message> received = net2.receive();
+    EXPECT_EQ(put, received);
+    EXPECT_EQ(nullptr, net2.receive());
+
+    net1.shutdown();
+    EXPECT_FALSE(net1.ready());
+}
+
+// Waiting for a message returns once one is sent from another thread
+TEST(KVNetLocalTest, waitAndReceive) {
+    KVNetLocal::Cluster cluster(2);
+    KVNetLocal net1(cluster);
+    KVNetLocal net2(cluster);
+    net1.registerNode("address", "port");
+    net2.registerNode("address", "port");
+
+    auto put = std::make_shared<Put>(1, Key("df", 2),
+                                     std::make_shared<DataFrame>());
+    std::thread sender([&] { net1.send(put); });
+    EXPECT_EQ(put, net2.waitAndReceive());
+    sender.join();
+}
+
+// Shutting down hands out the messages left, then wakes a waiting thread
+TEST(KVNetLocalTest, shutdownWakes) {
+    KVNetLocal::Cluster cluster(2);
+    KVNetLocal net1(cluster);
+    KVNetLocal net2(cluster);
+    net1.registerNode("address", "port");
+    net2.registerNode("address", "port");
+
+    auto put = std::make_shared<Put>(1, Key("df", 2),
+                                     std::make_shared<DataFrame>());
+    net1.send(put);
+    EXPECT_EQ(put, net2.waitAndReceive());
+
+    std::thread stopper([&] { net2.shutdown(); });
+    EXPECT_EQ(nullptr, net2.waitAndReceive());
+    stopper.join();
+}
+
+// KVStores on threads of one process share the DataFrames pushed and
+// fetched between them
+TEST(KVNetLocalTest, kvstores) {
+    KVNetLocal::Cluster cluster(3);
+    KVNetLocal net1(cluster), net2(cluster), net3(cluster);
+    {
+        KVStore store1(net1, "address", "port");
+        KVStore store2(net2, "address", "port");
+        KVStore store3(net3, "address", "port");
+
+        auto df = std::make_shared<DataFrame>();
+        auto col = std::make_shared<Column<int>>();
+        for (int ii = 0; ii < 1000; ii++) col->push_back(ii);
+        df->addCol(col);
+
+        // Which store is node 2 depends on the order they registered in, so
+        // all of them push and node 2 keeps the first
+        Key key("df", 2);
+        for (KVStore* store : {&store1, &store2, &store3}) {
+            store->push(key, df);
+        }
+
+        for (KVStore* store : {&store1, &store2, &store3}) {
+            EXPECT_EQ(df, store->waitAndGet(key));
+        }
+    }
+}
+
+}  // namespace
@@ -20,9 +20,13 @@
 
 #pragma once
 
+#include <sys/socket.h>
+#include <unistd.h>
+
 #include <iostream>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "ack.hpp"
@@ -37,6 +41,7 @@
 #include "register.hpp"
 #include "reply.hpp"
 #include "serializer.hpp"
+#include "tcpUtils.hpp"
 #include "testutils.hpp"
 #include "waitandget.hpp"
 
@@ -73,6 +78,100 @@ TEST_F(MessageTest, serialize) {
     // WaitAndGet waitandget(0, 1, 2);
 }
 
+// test for void onRelease(std::function<void()> callback);
+TEST_F(MessageTest, onRelease) {
+    bool released = false;
+    auto put = std::make_shared<Put>(1, Key("df", 2), df);
+    put->onRelease([&released] { released = true; });
+
+    std::shared_ptr<Message> queued = put;
+    put.reset();
+    EXPECT_FALSE(released);
+    queued.reset();
+    EXPECT_TRUE(released);
+}
+
+// A Put gathered from its columns' chunks arrives as the same bytes it
+// serializes to
+TEST_F(MessageTest, sendPieces) {
+    auto col = std::make_shared<Column<double>>();
+    for (size_t ii = 0; ii < 3 * Chunk<double>::size(); ii++)
+        col->push_back(ii);
+    auto df = std::make_shared<DataFrame>();
+    df->addCol(col);
+
+    Put put(1, *key, df);
+    Serializer ss;
+    put.serializeTo(ss);
+    ASSERT_GT(ss.pieces().size(), 3u);
+
+    int socks[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, socks));
+
+    std::vector<uint8_t> received;
+    std::thread reader([&] { TCP::recvData(socks[1], received, ss.size()); });
+    EXPECT_EQ(0, TCP::sendPieces(socks[0], ss.pieces()));
+    reader.join();
+    close(socks[0]);
+    close(socks[1]);
+
+    EXPECT_EQ(*put.serialize(), received);
+}
+
+// A Put read from a stream as it arrives matches the one sent
+TEST_F(MessageTest, receive) {
+    auto ints = std::make_shared<Column<int>>();
+    auto doubles = std::make_shared<Column<double>>();
+    auto strs = std::make_shared<Column<ExtString>>();
+    for (size_t ii = 0; ii < 2 * Chunk<int>::size() + 3; ii++) {
+        ints->push_back(ii * 3 - 7);
+        doubles->push_back(ii * 0.25);
+        strs->push_back(std::make_shared<std::string>(std::to_string(ii)));
+    }
+    ints->setMissing(5);
+    auto df = std::make_shared<DataFrame>();
+    df->addCol(ints);
+    df->addCol(doubles);
+    df->addCol(strs);
+
+    int socks[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, socks));
+
+    Put put(1, *key, df, 4, 2);
+    std::thread writer([&] {
+        Serializer ss;
+        put.serializeTo(ss);
+        TCP::sendPieces(socks[0], ss.pieces());
+    });
+
+    uint8_t hdr[Serial::CMD_HDR_SIZE];
+    ASSERT_EQ(0, TCP::recvData(socks[1], hdr, sizeof(hdr)));
+    std::unique_ptr<Message> msg =
+        Message::receive(hdr, [&](void* buf, size_t bytes) {
+            return TCP::recvData(socks[1], buf, bytes);
+        });
+    writer.join();
+    close(socks[0]);
+    close(socks[1]);
+
+    auto received = dynamic_cast<Put*>(msg.get());
+    ASSERT_NE(nullptr, received);
+    EXPECT_EQ(put.id(), received->id());
+    EXPECT_EQ(key->name(), received->key().name());
+
+    DFPtr df2 = received->value();
+    ASSERT_EQ(df->nrows(), df2->nrows());
+    ASSERT_EQ(3u, df2->ncols());
+    EXPECT_TRUE(df2->isMissing(0, 5));
+    for (size_t ii = 0; ii < df->nrows(); ii++) {
+        if (ii != 5) {
+            ASSERT_EQ(df->getInt(0, ii), df2->getInt(0, ii));
+        }
+        ASSERT_EQ(df->getDouble(1, ii), df2->getDouble(1, ii));
+        ASSERT_EQ(df->getString(2, ii), df2->getString(2, ii));
+    }
+}
+
 // test for void setupCmdHdr(Serializer& s);
 TEST_F(MessageTest, setupCmdHdr) {}
 
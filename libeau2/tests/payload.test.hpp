@@ -131,9 +131,10 @@ TEST_F(PayloadTest, add_ColPtrBool) {
     p.serialize(ss);
 
     auto bytes = ss.generate();
-    EXPECT_EQ(
-        Serial::PAYLOAD_HDR_SIZE + Serial::PAYLOAD_HDR_SIZE + 3 * sizeof(bool),
-        bytes->size());
+    // item count and 3 bits packed into a byte
+    EXPECT_EQ(Serial::PAYLOAD_HDR_SIZE + Serial::PAYLOAD_HDR_SIZE +
+                  sizeof(uint64_t) + 1,
+              bytes->size());
 }
 
 TEST_F(PayloadTest, add_ColPtrInt) {
@@ -199,9 +200,9 @@ TEST_F(PayloadTest, add_DFPtr) {
 
     auto bytes = ss.generate();
     EXPECT_EQ(Serial::PAYLOAD_HDR_SIZE
-                  // bool column
+                  // bool column, count and packed bits
                   + Serial::PAYLOAD_HDR_SIZE + Serial::PAYLOAD_HDR_SIZE +
-                  3 * sizeof(bool)
+                  sizeof(uint64_t) + 1
                   // int column
                   + Serial::PAYLOAD_HDR_SIZE + Serial::PAYLOAD_HDR_SIZE +
                   3 * sizeof(int)
@@ -302,6 +303,30 @@ TEST_F(PayloadTest, deserialize_df) {
     p.serialize(ss);
 }
 
+// Columns spanning several chunks are referenced when serialized and copied
+// straight into chunks when deserialized, even from an unaligned offset
+TEST_F(PayloadTest, deserialize_col_chunks) {
+    size_t count = 3 * Chunk<double>::size() + 5;
+    auto col = std::make_shared<Column<double>>();
+    for (size_t ii = 0; ii < count; ii++) col->push_back(ii * 0.5);
+
+    Payload p;
+    Serializer ss;
+    ASSERT_TRUE(p.add(col));
+    p.serialize(ss);
+    ASSERT_EQ(col->blocks() + 1, ss.pieces().size());
+
+    auto bytes = ss.generate();
+    bytes->insert(bytes->begin(), 0);
+
+    Payload p2;
+    ASSERT_EQ(bytes->end(), p2.deserialize(bytes->begin() + 1, bytes->end()));
+    ColPtr<double> col2 = p2.asColumn<double>();
+    ASSERT_NE(nullptr, col2);
+    ASSERT_EQ(count, col2->size());
+    for (size_t ii = 0; ii < count; ii++) ASSERT_EQ(ii * 0.5, col2->get(ii));
+}
+
 // test for Key Payload::asKey()
 
 // test for DFPtr Payload::asDataFrame()
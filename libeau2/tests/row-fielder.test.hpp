@@ -12,6 +12,7 @@
 #include <cstdlib>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "fielder.hpp"
@@ -94,7 +95,7 @@ TEST_F(RowTestExample, set_and_get) {
     ASSERT_EQ(1, r.getInt(7));
     ASSERT_EQ(2, r.getInt(8));
     ASSERT_EQ(3, r.getInt(9));
-    ASSERT_STREQ("Hello", r.getString(10)->c_str());
+    ASSERT_EQ("Hello", r.getString(10));
 }
 
 TEST_F(RowTest, set_get_idx) {
@@ -140,8 +141,8 @@ class RowTestExampleFielder : public Fielder {
     virtual void accept(int i) override {
         v_.push_back("int:" + std::to_string(i));
     }
-    virtual void accept(std::shared_ptr<std::string> s) override {
-        v_.push_back(std::string("string:") + s->c_str());
+    virtual void accept(std::string_view s) override {
+        v_.push_back(std::string("string:") + std::string(s));
     }
 
     virtual void done() override { v_.emplace_back("done"); }
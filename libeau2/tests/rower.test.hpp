@@ -0,0 +1,156 @@
+/**
+ * @file rower.test.hpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "column.hpp"
+#include "dataframe.hpp"
+#include "rowbatch.hpp"
+#include "rower.hpp"
+#include "testutils.hpp"
+
+namespace {
+
+// Sums the int column one row at a time, keeps even values
+class RowSum : public Rower {
+   public:
+    long sum = 0;
+
+    bool accept(Row& r) override {
+        sum += r.getInt(0);
+        return r.getInt(0) % 2 == 0;
+    }
+
+    void join_delete(Rower* other) override {
+        sum += dynamic_cast<RowSum*>(other)->sum;
+        delete other;
+    }
+
+    Rower* clone() override { return new RowSum; }
+};
+
+// Same as RowSum but scans whole column slices
+class BatchSum : public RowSum {
+   public:
+    size_t batches = 0;
+
+    void acceptBatch(RowBatch& batch) override {
+        Block<int> vals = batch.column<int>(0);
+        uint8_t* selected = batch.selected();
+
+        for (size_t ii = 0; ii < vals.size(); ii++) {
+            sum += vals[ii];
+            selected[ii] = vals[ii] % 2 == 0;
+        }
+        batches++;
+    }
+
+    Rower* clone() override { return new BatchSum; }
+};
+
+class RowerTest : public ::testing::Test {
+   protected:
+    DataFrame df;
+    size_t count;
+    long expected;
+
+    RowerTest() : count(3 * Chunk<int>::size() + 11), expected(0) {
+        auto ints = std::make_shared<Column<int>>();
+        auto doubles = std::make_shared<Column<double>>();
+        for (size_t ii = 0; ii < count; ii++) {
+            ints->push_back(static_cast<int>(ii));
+            doubles->push_back(ii * 0.5);
+            expected += ii;
+        }
+
+        df.addCol(ints);
+        df.addCol(doubles);
+    }
+};
+
+// test that batches are chunk aligned and cover every row
+TEST_F(RowerTest, batch_bounds) {
+    size_t batchSize = RowBatch::maxSize(df.getSchema());
+    EXPECT_EQ(Chunk<double>::size(), batchSize);
+
+    BatchSum rower;
+    df.map(rower);
+    EXPECT_EQ((count + batchSize - 1) / batchSize, rower.batches);
+    EXPECT_EQ(expected, rower.sum);
+}
+
+// test that the default batch accept visits every row
+TEST_F(RowerTest, map_default) {
+    RowSum rower;
+    df.map(rower);
+    EXPECT_EQ(expected, rower.sum);
+}
+
+// test both batch paths in parallel
+TEST_F(RowerTest, pmap) {
+    RowSum rowSum;
+    df.pmap(rowSum);
+    EXPECT_EQ(expected, rowSum.sum);
+
+    BatchSum batchSum;
+    df.pmap(batchSum);
+    EXPECT_EQ(expected, batchSum.sum);
+}
+
+// test that filters respect the batch selection
+TEST_F(RowerTest, filter) {
+    RowSum rowSum;
+    DFPtr rowRes = df.filter(rowSum);
+    BatchSum batchSum;
+    DFPtr batchRes = df.filter(batchSum);
+
+    EXPECT_EQ(expected, rowSum.sum);
+    EXPECT_EQ(expected, batchSum.sum);
+    ASSERT_EQ((count + 1) / 2, rowRes->nrows());
+    ASSERT_EQ(rowRes->nrows(), batchRes->nrows());
+    for (size_t ii = 0; ii < rowRes->nrows(); ii++) {
+        EXPECT_EQ(static_cast<int>(2 * ii), rowRes->getInt(0, ii));
+        EXPECT_EQ(static_cast<int>(2 * ii), batchRes->getInt(0, ii));
+        EXPECT_EQ(ii * 1.0, batchRes->getDouble(1, ii));
+    }
+}
+
+// Keeps rows whose bool column is set
+class KeepTrue : public RowSum {
+   public:
+    bool accept(Row& r) override { return r.getBool(0); }
+
+    Rower* clone() override { return new KeepTrue; }
+};
+
+class FilterTest : public FixtureWithSmallDataFrame {};
+
+// test filtering every column type into a new frame
+TEST_F(FilterTest, small_frame) {
+    KeepTrue keep;
+    DFPtr res = df->filter(keep);
+
+    ASSERT_EQ(2u, res->nrows());
+    ASSERT_EQ(4u, res->ncols());
+    EXPECT_EQ("intcol", res->getSchema().colName(1));
+    EXPECT_TRUE(res->getBool(0, 1));
+    EXPECT_EQ(42, res->getInt(1, 1));
+    EXPECT_EQ("ghi", res->getString(2, 1));
+    EXPECT_EQ(-10000.0, res->getDouble(3, 1));
+    EXPECT_EQ(3u, df->nrows());
+
+    // nothing survives an empty frame
+    DataFrame empty(*res);
+    EXPECT_EQ(0u, empty.filter(keep)->nrows());
+}
+
+}  // namespace
@@ -33,8 +33,8 @@ TEST(SerialUnitTests, valueToType) {
     ASSERT_EQ(Serial::Type::Column, Serial::valueToType(12));
     ASSERT_EQ(Serial::Type::Key, Serial::valueToType(13));
     ASSERT_EQ(Serial::Type::DataFrame, Serial::valueToType(14));
-    ASSERT_EQ(Serial::Type::Unknown, Serial::valueToType(15));
-    ASSERT_EQ(Serial::Type::Unknown, Serial::valueToType(16));
+    ASSERT_EQ(Serial::Type::DictString, Serial::valueToType(15));
+    ASSERT_EQ(Serial::Type::Encoded, Serial::valueToType(16));
     ASSERT_EQ(Serial::Type::Unknown, Serial::valueToType(17));
     ASSERT_EQ(Serial::Type::Unknown, Serial::valueToType(18));
 }
@@ -55,6 +55,8 @@ TEST(SerialUnitTests, typeToValue) {
     ASSERT_EQ(12, Serial::typeToValue(Serial::Type::Column));
     ASSERT_EQ(13, Serial::typeToValue(Serial::Type::Key));
     ASSERT_EQ(14, Serial::typeToValue(Serial::Type::DataFrame));
+    ASSERT_EQ(15, Serial::typeToValue(Serial::Type::DictString));
+    ASSERT_EQ(16, Serial::typeToValue(Serial::Type::Encoded));
     ASSERT_EQ(UINT8_MAX, Serial::typeToValue(Serial::Type::Unknown));
 }
 
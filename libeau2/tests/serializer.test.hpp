@@ -23,4 +23,30 @@ TEST(SerializerTest, basic) {
     
 }
 
+// Short references are copied, long ones become pieces of their own
+TEST(SerializerTest, addRef) {
+    std::vector<uint8_t> big(Serializer::MIN_REF_BYTES, 7);
+    uint8_t small[4] = {1, 2, 3, 4};
+    Serializer ss;
+
+    ss.add<uint8_t>(9).addRef(big.data(), big.size());
+    ss.addRef(small, sizeof(small)).addRef(big.data(), big.size());
+
+    auto pieces = ss.pieces();
+    ASSERT_EQ(4u, pieces.size());
+    ASSERT_EQ(1u, pieces[0].size);
+    ASSERT_EQ(big.data(), pieces[1].data);
+    ASSERT_EQ(sizeof(small), pieces[2].size);
+    ASSERT_EQ(big.data(), pieces[3].data);
+    ASSERT_EQ(1 + sizeof(small) + 2 * big.size(), ss.size());
+
+    auto bytes = ss.generate();
+    ASSERT_EQ(1 + sizeof(small) + 2 * big.size(), bytes->size());
+    ASSERT_EQ(9, (*bytes)[0]);
+    ASSERT_EQ(7, (*bytes)[1]);
+    ASSERT_EQ(1, (*bytes)[1 + big.size()]);
+    ASSERT_EQ(7, bytes->back());
+    ASSERT_EQ(0u, ss.size());
+}
+
 } // namespace
\ No newline at end of file
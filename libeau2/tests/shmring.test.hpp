@@ -0,0 +1,94 @@
+/**
+ * @file shmring.test.hpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "shmring.hpp"
+
+namespace {
+
+// Unique to the test process so parallel runs don't share rings
+std::string ringName(const char* test) {
+    return std::string("/eau2-test-") + test + '-' + std::to_string(getpid());
+}
+
+// Messages larger than the ring wrap around it while the reader keeps up
+TEST(ShmRingTest, wrap) {
+    std::string name = ringName("wrap");
+    std::unique_ptr<ShmRing> in = ShmRing::create(name, 64);
+    ASSERT_NE(nullptr, in);
+
+    std::vector<uint8_t> message(1000);
+    for (size_t ii = 0; ii < message.size(); ii++) message[ii] = ii * 7;
+
+    // Opening waits for the reader to acknowledge it from a read
+    std::thread writer([&] {
+        std::unique_ptr<ShmRing> out = ShmRing::open(name);
+        ASSERT_NE(nullptr, out);
+        EXPECT_EQ(0, out->write({{message.data(), 10},
+                                 {message.data() + 10, message.size() - 10}}));
+    });
+
+    std::vector<uint8_t> read(message.size());
+    EXPECT_EQ(0, in->read(read.data(), 3));
+    EXPECT_EQ(0, in->read(read.data() + 3, read.size() - 3));
+    writer.join();
+
+    EXPECT_EQ(message, read);
+}
+
+// What was written before the writer closed can still be read, waiting for
+// more fails
+TEST(ShmRingTest, close) {
+    std::string name = ringName("close");
+    std::unique_ptr<ShmRing> in = ShmRing::create(name, 64);
+    ASSERT_NE(nullptr, in);
+
+    std::thread writer([&] {
+        std::unique_ptr<ShmRing> out = ShmRing::open(name);
+        ASSERT_NE(nullptr, out);
+        uint8_t buf[64] = {1, 2, 3};
+        EXPECT_EQ(0, out->write({{buf, 3}}));
+        out->close();
+        EXPECT_NE(0, out->write({{buf, 3}}));
+    });
+
+    uint8_t read[64] = {};
+    EXPECT_EQ(0, in->read(read, 3));
+    EXPECT_EQ(3, read[2]);
+    EXPECT_NE(0, in->read(read, 1));
+    writer.join();
+}
+
+// A ring nobody reads, like one left behind by a run that crashed, can't be
+// opened
+TEST(ShmRingTest, unread) {
+    std::string name = ringName("unread");
+    std::unique_ptr<ShmRing> in = ShmRing::create(name, 64);
+    ASSERT_NE(nullptr, in);
+    EXPECT_EQ(nullptr, ShmRing::open(name));
+}
+
+// Removed once the side that created it is gone
+TEST(ShmRingTest, unlink) {
+    std::string name = ringName("unlink");
+    EXPECT_EQ(nullptr, ShmRing::open(name));
+    ShmRing::create(name, 64).reset();
+    EXPECT_EQ(nullptr, ShmRing::open(name));
+}
+
+}  // namespace
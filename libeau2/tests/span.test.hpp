@@ -0,0 +1,70 @@
+/**
+ * @file span.test.hpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+
+#include "column.hpp"
+#include "dataframe.hpp"
+#include "span.hpp"
+#include "testutils.hpp"
+
+namespace {
+
+class SpanTest : public FixtureWithSmallDataFrame {};
+
+// test that a small column is a single block
+TEST_F(SpanTest, small_column) {
+    ColumnSpan<double> span = df->column<double>(3);
+
+    ASSERT_EQ(1u, span.blocks());
+    ASSERT_EQ(3u, span.size());
+
+    Block<double> block = span.block(0);
+    ASSERT_EQ(3u, block.size());
+    EXPECT_EQ(5.0, block[0]);
+    EXPECT_EQ(0.0, block[1]);
+    EXPECT_EQ(-10000.0, block[2]);
+}
+
+// test viewing a column as the wrong type
+TEST_F(SpanTest, wrong_type) {
+    ASSERT_THROW(df->column<int>(3), std::runtime_error);
+    ASSERT_NO_THROW(df->column<int>(1));
+}
+
+// test summing a column that spans multiple chunks
+TEST(SpanTestBig, sum_blocks) {
+    auto col = std::make_shared<Column<int>>();
+    size_t count = 3 * Chunk<int>::size() + 7;
+    long expected = 0;
+    for (size_t ii = 0; ii < count; ii++) {
+        col->push_back(static_cast<int>(ii));
+        expected += ii;
+    }
+
+    DataFrame df;
+    df.addCol(col);
+
+    long sum = 0;
+    size_t items = 0;
+    for (const Block<int>& block : df.column<int>(0)) {
+        for (int val : block) sum += val;
+        items += block.size();
+    }
+
+    EXPECT_EQ(4u, df.column<int>(0).blocks());
+    EXPECT_EQ(count, items);
+    EXPECT_EQ(expected, sum);
+}
+
+}  // namespace
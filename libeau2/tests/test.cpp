@@ -11,15 +11,27 @@
 #include "gtest/gtest.h"
 
 #include "column_int.test.hpp"
+#include "column_string.test.hpp"
+#include "bitmap.test.hpp"
 #include "schema.test.hpp"
 #include "row-fielder.test.hpp"
 // #include "kvstore.test.hpp" // segfaults
 // #include "dataframe.test.hpp" // Not working for some reason
 #include "dataframe_fromColumnSet.test.hpp"
+#include "dataframe_fromFile.test.hpp"
 #include "serial.test.hpp"
 #include "serializer.test.hpp"
 #include "payload.test.hpp"
 #include "message.test.hpp"
+#include "span.test.hpp"
+#include "rower.test.hpp"
+#include "executor.test.hpp"
+#include "validity.test.hpp"
+#include "columnfile.test.hpp"
+#include "encoding.test.hpp"
+#include "frame.test.hpp"
+#include "shmring.test.hpp"
+#include "kvnetLocal.test.hpp"
 
 int main(int argc, char** argv) {
     std::cout << "test" << std::endl;
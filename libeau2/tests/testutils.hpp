@@ -10,6 +10,7 @@
 
 #include <gtest/gtest.h>
 
+#include <condition_variable>
 #include <mutex>
 #include <queue>
 #include <string>
@@ -106,6 +107,9 @@ class FixtureWithSmallDataFrame : public ::testing::Test {
 class KVNetMock : public KVNet {
    public:
     std::queue<std::shared_ptr<Message>> nodeMsgs;
+    std::mutex lock;  // messages may be sent from several threads
+    std::condition_variable sent;  // notified as messages are sent
+    bool stopped = false;          // set by shutdown()
 
    public:
     KVNetMock() : KVNet() {}
@@ -116,10 +120,13 @@ class KVNetMock : public KVNet {
     }
 
     virtual void send(std::shared_ptr<Message> msg) override {
+        std::lock_guard<std::mutex> guard(lock);
         nodeMsgs.push(msg);
+        sent.notify_one();
     }
 
-    virtual std::unique_ptr<Message> receive() override {
+    virtual std::shared_ptr<Message> receive() override {
+        std::lock_guard<std::mutex> guard(lock);
         if (!nodeMsgs.empty()) {
             auto msg = std::move(nodeMsgs.front());
             nodeMsgs.pop();
@@ -129,9 +136,24 @@ class KVNetMock : public KVNet {
         return nullptr;
     }
 
+    virtual std::shared_ptr<Message> waitAndReceive() override {
+        std::unique_lock<std::mutex> guard(lock);
+        sent.wait(guard, [this] { return !nodeMsgs.empty() || stopped; });
+        if (nodeMsgs.empty()) return nullptr;
+        auto msg = std::move(nodeMsgs.front());
+        nodeMsgs.pop();
+        return Message::deserialize(msg->serialize());
+    }
+
     virtual bool ready() override { return true; }
 
-    virtual void shutdown() override {}
+    virtual void shutdown() override {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopped = true;
+        }
+        sent.notify_all();
+    }
 };
 
 class FixtureWithKVStore : public FixtureWithSmallDataFrame {
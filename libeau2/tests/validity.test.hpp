@@ -0,0 +1,142 @@
+/**
+ * @file validity.test.hpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ * Lang::Cpp
+ */
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "column.hpp"
+#include "dataframe.hpp"
+#include "fielder.hpp"
+#include "payload.hpp"
+#include "row.hpp"
+#include "rower.hpp"
+#include "serializer.hpp"
+#include "testutils.hpp"
+
+namespace {
+
+// Counts present and missing fields
+class MissingCounter : public Fielder {
+   public:
+    size_t present = 0;
+    size_t missing = 0;
+
+    void accept(bool b) override { present++; }
+    void accept(double d) override { present++; }
+    void accept(int i) override { present++; }
+    void accept(std::string_view s) override { present++; }
+    void acceptMissing() override { missing++; }
+};
+
+// Keeps rows whose bool column is set
+class KeepSet : public Rower {
+   public:
+    bool accept(Row& r) override { return r.getBool(0); }
+
+    void join_delete(Rower* other) override { delete other; }
+
+    Rower* clone() override { return new KeepSet; }
+};
+
+class ValidityTest : public FixtureWithSmallDataFrame {
+   protected:
+    ValidityTest() {
+        df->getSchema().setNullable(1, true);
+        c2->setMissing(1);
+        c3->setMissing(2);
+    }
+};
+
+// test missing items and the per chunk counts of a long column
+TEST(ColumnValidityTest, missing_items) {
+    Column<int> col;
+    for (int ii = 0; ii < 20000; ii++) col.push_back(ii);
+    EXPECT_EQ(0u, col.nullCount());
+    EXPECT_EQ(nullptr, col.validity().present());
+
+    col.setMissing(10000);
+    col.pushMissing();
+    EXPECT_EQ(20001u, col.size());
+    EXPECT_EQ(2u, col.nullCount());
+    EXPECT_TRUE(col.isMissing(10000));
+    EXPECT_TRUE(col.isMissing(20000));
+    EXPECT_EQ(0, col.get(20000));
+
+    EXPECT_FALSE(col.validity().anyMissing(0, 8192));
+    EXPECT_TRUE(col.validity().anyMissing(8192, 8192));
+
+    // setting a value makes it present again
+    col.set(10000, 5);
+    EXPECT_FALSE(col.isMissing(10000));
+    EXPECT_EQ(1u, col.nullCount());
+
+    Column<bool> bools{true, false};
+    bools.pushMissing();
+    EXPECT_TRUE(bools.isMissing(2));
+    EXPECT_FALSE(bools.get(2));
+}
+
+// test that rows carry missing fields to fielders and back into frames
+TEST_F(ValidityTest, row_fielder) {
+    Row row(df->getSchema());
+    df->fillRow(1, row);
+    EXPECT_TRUE(row.isMissing(1));
+    EXPECT_FALSE(row.isMissing(2));
+
+    MissingCounter counter;
+    row.visit(1, counter);
+    EXPECT_EQ(3u, counter.present);
+    EXPECT_EQ(1u, counter.missing);
+
+    df->add_row(row);
+    EXPECT_EQ(4u, df->nrows());
+    EXPECT_TRUE(df->isMissing(1, 3));
+    EXPECT_FALSE(df->isMissing(2, 3));
+
+    row.set(1, 7);
+    EXPECT_FALSE(row.isMissing(1));
+}
+
+// test that missing values survive serialization
+TEST_F(ValidityTest, payload) {
+    Payload p;
+    Serializer ss;
+    p.add(df);
+    p.serialize(ss);
+    auto bytes = ss.generate();
+
+    Payload p2;
+    p2.deserialize(bytes->begin(), bytes->end());
+    DFPtr df2 = p2.asDataFrame();
+
+    ASSERT_EQ(3u, df2->nrows());
+    EXPECT_TRUE(df2->isMissing(1, 1));
+    EXPECT_TRUE(df2->isMissing(2, 2));
+    EXPECT_FALSE(df2->isMissing(1, 0));
+    EXPECT_FALSE(df2->isMissing(0, 1));
+    EXPECT_TRUE(df2->getSchema().isNullable(1));
+    EXPECT_FALSE(df2->getSchema().isNullable(0));
+    EXPECT_EQ(42, df2->getInt(1, 2));
+}
+
+// test that filtering keeps missing values on the surviving rows
+TEST_F(ValidityTest, filter) {
+    KeepSet keep;
+    DFPtr res = df->filter(keep);
+
+    ASSERT_EQ(2u, res->nrows());
+    EXPECT_FALSE(res->isMissing(1, 0));
+    EXPECT_FALSE(res->isMissing(1, 1));
+    EXPECT_FALSE(res->isMissing(2, 0));
+    EXPECT_TRUE(res->isMissing(2, 1));
+}
+
+}  // namespace
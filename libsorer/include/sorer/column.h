@@ -14,6 +14,7 @@
 #include <string.h>
 
 #include "sorer/object.h"
+#include "sorer/sink.h"
 
 namespace ne {
 
@@ -207,9 +208,10 @@ class BoolColumn : public BaseColumn {
 };
 
 /**
- * Represents a fixed-size set of columns of potentially different types.
+ * Represents a fixed-size set of columns of potentially different types. Parsed fields can be
+ * appended to it as a FieldSink.
  */
-class ColumnSet : public Object {
+class ColumnSet : public FieldSink {
    public:
     /** The array of columns */
     BaseColumn** _columns;
@@ -249,6 +251,23 @@ class ColumnSet : public Object {
      * @return The column with the given index
      */
     virtual BaseColumn* getColumn(size_t which);
+
+    /**
+     * Appends a copy of the given string to the string column with the given index.
+     */
+    virtual void appendString(size_t column, const char* str, size_t length) override;
+
+    /**
+     * Appends a value to the column of the matching type with the given index.
+     */
+    virtual void appendInt(size_t column, int value) override;
+    virtual void appendFloat(size_t column, float value) override;
+    virtual void appendBool(size_t column, bool value) override;
+
+    /**
+     * Appends a missing entry to the column with the given index.
+     */
+    virtual void appendMissing(size_t column) override;
 };
 
 }  // namespace ne
\ No newline at end of file
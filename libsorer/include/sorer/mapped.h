@@ -0,0 +1,78 @@
+/**
+ * @file mapped.h
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ *
+ * Lang::Cpp
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+#include "sorer/object.h"
+
+namespace ne {
+
+/**
+ * A read-only memory mapping of a whole file. Lines can be read straight out of the mapping
+ * without copying them through a buffer, and the file can be split into line aligned segments
+ * that are parsed independently.
+ */
+class MappedFile : public Object {
+   public:
+    /** Start of the mapping, nullptr if the file could not be mapped */
+    const char* _data;
+    /** Size of the file in bytes */
+    size_t _size;
+    /** Whether the file was opened, and mapped unless it is empty */
+    bool _open;
+
+    /**
+     * Maps the file with the given name. Check isOpen() for failures.
+     * @param filename The file to map
+     */
+    MappedFile(const char* filename);
+
+    /**
+     * Unmaps the file
+     */
+    virtual ~MappedFile();
+
+    /**
+     * @return Whether the file was opened and, unless it is empty, mapped
+     */
+    virtual bool isOpen();
+
+    /**
+     * @return The contents of the file, not null terminated
+     */
+    virtual const char* getData();
+
+    /**
+     * @return The size of the file in bytes
+     */
+    virtual size_t getSize();
+
+    /**
+     * Finds the start of the first line beginning at or after the given position.
+     * @param pos The byte index to search from
+     * @return pos if a line starts there, otherwise the index just past the next newline, or
+     *         the file size if there is none
+     */
+    virtual size_t nextLine(size_t pos);
+
+    /**
+     * Splits [start, end) into the given number of segments that all begin at the start of a line,
+     * except possibly the first, and end just past a newline, except possibly the last. Segments
+     * may be empty when lines are longer than the segment size.
+     * @param start The first byte to split
+     * @param end The byte past the last one to split
+     * @param parts The number of segments
+     * @param bounds Array of parts + 1 indices to fill, segment i is [bounds[i], bounds[i + 1])
+     */
+    virtual void split(size_t start, size_t end, size_t parts, size_t* bounds);
+};
+
+} // namespace ne
@@ -68,13 +68,13 @@ class StrSlice : public Object {
     virtual char* toCString();
 
     /**
-     * Parses the contents of this slice as an int.
+     * Parses the contents of this slice as an int, without allocating.
      * @return An int corresponding to the digits in this slice.
      */
     virtual int toInt();
 
     /**
-     * Parses the contents of this slice as a float.
+     * Parses the contents of this slice as a float, without allocating.
      * @return The float
      */
     virtual float toFloat();
@@ -180,6 +180,16 @@ class SorParser : public Object {
      */
     static bool isNumeric(char c);
 
+    /**
+     * Finds the next char in the line that is a field delimiter or string quote. Uses AVX2 or
+     * SSE2 to check a vector of chars at a time when the target supports them.
+     * @param line The line to search
+     * @param start The index to start searching at
+     * @param length The number of chars in the line
+     * @return The index of the next '<', '>' or '"', or length if there is none
+     */
+    static size_t findDelimiter(const char* line, size_t start, size_t length);
+
     /** LineReader we're using */
     LineReader* _reader;
     /** ColumnSet for data we will ultimately parse */
@@ -198,6 +208,19 @@ class SorParser : public Object {
      */
     SorParser(FILE* file, size_t file_start, size_t file_end, size_t file_size);
 
+    /**
+     * Creates a new SorParser without a file or a schema. Its schema is guessed with guessLines().
+     */
+    SorParser();
+
+    /**
+     * Creates a new SorParser for an already known schema. It has no file of its own and is
+     * given lines through parseLine(), so several parsers can work on parts of the same file.
+     * @param types The type of each column, copied
+     * @param num_columns The number of columns
+     */
+    SorParser(const ColumnType* types, size_t num_columns);
+
     /**
      * Destructor for SorParser
      */
@@ -208,13 +231,37 @@ class SorParser : public Object {
      * using the type of the column.
      * @param slice The slice containing the data for this field
      * @param field_num The column index
-     * @param columns The ColumnSet to add the data to
+     * @param sink Where to add the data, such as a ColumnSet
      */
-    virtual void _appendField(StrSlice slice, size_t field_num, ColumnSet* columns);
+    virtual void _appendField(StrSlice slice, size_t field_num, FieldSink* sink);
+
+    /**
+     * Guesses the type of a single field. Fields made up only of numeric chars are floats when
+     * they have a dot, and otherwise bools when they are 0 or 1 and integers if not. Anything
+     * else is a string.
+     * @param slice The slice containing the field, trimmed of spaces
+     * @return The guessed type, UNKNOWN for an empty field
+     */
+    static ColumnType guessType(StrSlice slice);
+
+    /**
+     * Combines two guesses for the same column into the narrowest type that can hold both. Types
+     * widen from UNKNOWN to BOOL, INTEGER, FLOAT and finally STRING.
+     * @param a The first guess
+     * @param b The second guess
+     * @return The combined guess
+     */
+    static ColumnType mergeTypes(ColumnType a, ColumnType b);
+
+    /**
+     * Widens the type guesses to the given number of columns, new columns start as UNKNOWN.
+     * @param num_columns The new number of columns, smaller values are ignored
+     */
+    virtual void _growGuesses(size_t num_columns);
 
     /**
      * Tries to guess or update the guess for the given column index given a field contained in the
-     * given StrSlice.
+     * given StrSlice. Columns past the ones seen so far are added.
      * @param slice The slice to use
      * @param field_num The column index
      */
@@ -225,9 +272,27 @@ class SorParser : public Object {
      * given parsing mode.
      * @param line The line to scan/parse
      * @param mode The mode to use
-     * @param columns The data representation to update
+     * @param sink The data representation to update
+     */
+    virtual size_t _scanLine(const char* line, ParserMode mode, FieldSink* sink);
+
+    /**
+     * Same as above for a line of the given length, which need not be null terminated.
+     * @param line The line to scan/parse
+     * @param length The number of chars in the line
+     * @param mode The mode to use
+     * @param sink The data representation to update
+     */
+    virtual size_t _scanLine(const char* line, size_t length, ParserMode mode, FieldSink* sink);
+
+    /**
+     * Appends the fields of a single line to the given columns, columns that the line has no
+     * field for get a missing entry. Fields past the last column are ignored.
+     * @param line The line to parse, need not be null terminated
+     * @param length The number of chars in the line
+     * @param sink The data representation to update, such as a ColumnSet
      */
-    virtual size_t _scanLine(const char* line, ParserMode mode, ColumnSet* columns);
+    virtual void parseLine(const char* line, size_t length, FieldSink* sink);
 
     /**
      * Attempts to guess the schema based on the first 500 lines in the file.
@@ -235,12 +300,41 @@ class SorParser : public Object {
      */
     virtual void guessSchema();
 
+    /**
+     * Guesses the schema from up to max_lines lines of the given text in a single pass, widening
+     * the guesses made so far. Parsers guessing different parts of a file can be combined with
+     * mergeSchema().
+     * @param data The lines to guess from, need not be null terminated
+     * @param length The number of chars in data
+     * @param max_lines The maximum number of lines to look at
+     * @return The number of chars looked at
+     */
+    virtual size_t guessLines(const char* data, size_t length, size_t max_lines);
+
+    /**
+     * Widens this parser's guesses with the guesses of another parser for the same file.
+     * @param other The other parser, must not have initialized its columns yet
+     */
+    virtual void mergeSchema(SorParser* other);
+
+    /**
+     * Settles the guessed schema and creates the ColumnSet for it. Columns without any guess are
+     * assumed to be bools. Called by guessSchema(), or after guessLines() and mergeSchema().
+     */
+    virtual void initializeColumns();
+
     /**
      * Parses all the data in the file (between the start index and length).
      * guessSchema() must be called before this functions. Can only be called once.
      */
     virtual void parseFile();
 
+    /**
+     * Same as above, but appends the data to the given sink instead of this parser's ColumnSet.
+     * @param sink The data representation to update
+     */
+    virtual void parseFile(FieldSink* sink);
+
     /**
      * Gets the in-memory representation for the sor data.
      * guessSchema() and parseFile() must be called before this function.
@@ -0,0 +1,60 @@
+/**
+ * @file sink.h
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ *
+ *
+ * Lang::Cpp
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+#include "sorer/object.h"
+
+namespace ne {
+
+/**
+ * Receives the fields of each parsed line, in column order. Implementations decide where the data
+ * is stored, so a parser can write straight into another library's columns instead of a ColumnSet.
+ */
+class FieldSink : public Object {
+   public:
+    /**
+     * Appends a string field to the given column.
+     * @param column The column index
+     * @param str The chars of the string, not null terminated and only valid during the call
+     * @param length The number of chars
+     */
+    virtual void appendString(size_t column, const char* str, size_t length) = 0;
+
+    /**
+     * Appends an integer field to the given column.
+     * @param column The column index
+     * @param value The value
+     */
+    virtual void appendInt(size_t column, int value) = 0;
+
+    /**
+     * Appends a float field to the given column.
+     * @param column The column index
+     * @param value The value
+     */
+    virtual void appendFloat(size_t column, float value) = 0;
+
+    /**
+     * Appends a bool field to the given column.
+     * @param column The column index
+     * @param value The value
+     */
+    virtual void appendBool(size_t column, bool value) = 0;
+
+    /**
+     * Appends a missing field to the given column.
+     * @param column The column index
+     */
+    virtual void appendMissing(size_t column) = 0;
+};
+
+} // namespace ne
@@ -277,7 +277,7 @@ void BoolColumn::_printEntry(size_t which) { printf("%d\n", _entries[which]); }
  * Caller must also call initializeColumn for each column to fully initialize this class.
  * @param num_columns The max number of columns that can be held
  */
-ColumnSet::ColumnSet(size_t num_columns) : Object() {
+ColumnSet::ColumnSet(size_t num_columns) : FieldSink() {
     _columns = new BaseColumn*[num_columns];
     _length = num_columns;
     for (size_t i = 0; i < num_columns; i++) {
@@ -348,4 +348,34 @@ BaseColumn* ColumnSet::getColumn(size_t which) {
     return _columns[which];
 }
 
+/**
+ * Appends a copy of the given string to the string column with the given index.
+ */
+void ColumnSet::appendString(size_t column, const char* str, size_t length) {
+    char* copy = new char[length + 1];
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+    dynamic_cast<StringColumn*>(getColumn(column))->append(copy);
+}
+
+/**
+ * Appends a value to the column of the matching type with the given index.
+ */
+void ColumnSet::appendInt(size_t column, int value) {
+    dynamic_cast<IntegerColumn*>(getColumn(column))->append(value);
+}
+
+void ColumnSet::appendFloat(size_t column, float value) {
+    dynamic_cast<FloatColumn*>(getColumn(column))->append(value);
+}
+
+void ColumnSet::appendBool(size_t column, bool value) {
+    dynamic_cast<BoolColumn*>(getColumn(column))->append(value);
+}
+
+/**
+ * Appends a missing entry to the column with the given index.
+ */
+void ColumnSet::appendMissing(size_t column) { getColumn(column)->appendMissing(); }
+
 } //namespace ne
\ No newline at end of file
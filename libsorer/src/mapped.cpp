@@ -0,0 +1,130 @@
+/**
+ * @file mapped.cpp
+ * @author Vincent Zhao (zhao.v@northeastern.edu)
+ * @author Michael Hebert (mike.s.hebert@gmail.com)
+ */
+
+#include <assert.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "sorer/mapped.h"
+
+namespace ne {
+
+/**
+ * Maps the file with the given name. Check isOpen() for failures.
+ * @param filename The file to map
+ */
+MappedFile::MappedFile(const char* filename) : Object() {
+    _data = nullptr;
+    _size = 0;
+    _open = false;
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        perror("open");
+        return;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) < 0) {
+        perror("fstat");
+        close(fd);
+        return;
+    }
+    _size = info.st_size;
+
+    // An empty file cannot be mapped, it is simply open with no data
+    if (_size > 0) {
+        void* map = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            perror("mmap");
+            _size = 0;
+            close(fd);
+            return;
+        }
+        _data = static_cast<const char*>(map);
+        // the file is parsed front to back
+        madvise(map, _size, MADV_SEQUENTIAL);
+    }
+    _open = true;
+
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+}
+
+/**
+ * Unmaps the file
+ */
+MappedFile::~MappedFile() {
+    if (_data != nullptr) {
+        munmap(const_cast<char*>(_data), _size);
+    }
+}
+
+/**
+ * @return Whether the file was opened and, unless it is empty, mapped
+ */
+bool MappedFile::isOpen() { return _open; }
+
+/**
+ * @return The contents of the file, not null terminated
+ */
+const char* MappedFile::getData() { return _data; }
+
+/**
+ * @return The size of the file in bytes
+ */
+size_t MappedFile::getSize() { return _size; }
+
+/**
+ * Finds the start of the first line beginning at or after the given position.
+ * @param pos The byte index to search from
+ * @return pos if a line starts there, otherwise the index just past the next newline, or the
+ *         file size if there is none
+ */
+size_t MappedFile::nextLine(size_t pos) {
+    if (pos == 0 || pos > _size) {
+        return pos > _size ? _size : 0;
+    }
+    if (_data[pos - 1] == '\n') {
+        return pos;
+    }
+
+    const void* newline = memchr(&_data[pos], '\n', _size - pos);
+    if (newline == nullptr) {
+        return _size;
+    }
+    return static_cast<const char*>(newline) - _data + 1;
+}
+
+/**
+ * Splits [start, end) into the given number of segments that all begin at the start of a line,
+ * except possibly the first, and end just past a newline, except possibly the last. Segments
+ * may be empty when lines are longer than the segment size.
+ * @param start The first byte to split
+ * @param end The byte past the last one to split
+ * @param parts The number of segments
+ * @param bounds Array of parts + 1 indices to fill, segment i is [bounds[i], bounds[i + 1])
+ */
+void MappedFile::split(size_t start, size_t end, size_t parts, size_t* bounds) {
+    assert(parts > 0);
+    assert(start <= end && end <= _size);
+
+    size_t step = (end - start) / parts;
+    bounds[0] = start;
+    for (size_t i = 1; i < parts; i++) {
+        size_t bound = nextLine(start + i * step);
+        if (bound < bounds[i - 1]) {
+            bound = bounds[i - 1];
+        }
+        bounds[i] = bound < end ? bound : end;
+    }
+    bounds[parts] = end;
+}
+
+} // namespace ne
@@ -8,6 +8,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <charconv>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 #include "sorer/parser.h"
 #include "sorer/column.h"
 
@@ -74,24 +80,17 @@ char* StrSlice::toCString() {
  * @return An int corresponding to the digits in this slice.
  */
 int StrSlice::toInt() {
-    // Roll a custom integer parsing function to avoid having to allocate a new null-terminated
-    // string for atoi and friends.
-    long result = 0;
-    bool is_negative = false;
-    for (size_t i = _start; i < _end; i++) {
-        char c = _str[i];
-        if (i == _start && c == '-') {
-            is_negative = true;
-            continue;
-        } else if (i == _start && c == '+') {
-            continue;
-        } else if (c >= '0' && c <= '9') {
-            result = result * 10 + (c - '0');
-        } else {
-            break;
-        }
+    // std::from_chars parses straight out of the slice without a null-terminated copy, but does
+    // not accept a leading plus. Anything after the digits is ignored and no digits parses as 0.
+    const char* begin = getChars();
+    const char* end = begin + getLength();
+    if (begin < end && *begin == '+') {
+        begin++;
     }
-    return is_negative ? -result : result;
+
+    long result = 0;
+    std::from_chars(begin, end, result);
+    return result;
 }
 
 /**
@@ -99,11 +98,15 @@ int StrSlice::toInt() {
  * @return The float
  */
 float StrSlice::toFloat() {
-    // It's hard to roll a float parsing function by hand, so bite the bullet and allocate a
-    // null-terminated string for atof.
-    char* cstr = toCString();
-    float result = atof(cstr);
-    delete[] cstr;
+    // Same as toInt, a slice that is not a float parses as 0 like atof
+    const char* begin = getChars();
+    const char* end = begin + getLength();
+    if (begin < end && *begin == '+') {
+        begin++;
+    }
+
+    float result = 0;
+    std::from_chars(begin, end, result);
     return result;
 }
 
@@ -273,6 +276,57 @@ bool SorParser::isNumeric(char c) {
     return c == MINUS || c == PLUS || c == DOT || (c >= '0' && c <= '9');
 }
 
+/**
+ * Finds the next char in the line that is a field delimiter or string quote.
+ * @param line The line to search
+ * @param start The index to start searching at
+ * @param length The number of chars in the line
+ * @return The index of the next '<', '>' or '"', or length if there is none
+ */
+size_t SorParser::findDelimiter(const char* line, size_t start, size_t length) {
+    size_t i = start;
+
+    // Compare a whole vector of chars against each delimiter at once and take the first match
+#ifdef __AVX2__
+    const __m256i begin32 = _mm256_set1_epi8(FIELD_BEGIN);
+    const __m256i end32 = _mm256_set1_epi8(FIELD_END);
+    const __m256i quote32 = _mm256_set1_epi8(STRING_QUOTE);
+    for (; i + 32 <= length; i += 32) {
+        __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&line[i]));
+        __m256i found = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chars, begin32), _mm256_cmpeq_epi8(chars, end32)),
+            _mm256_cmpeq_epi8(chars, quote32));
+        unsigned mask = _mm256_movemask_epi8(found);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+#endif
+#ifdef __SSE2__
+    const __m128i begin16 = _mm_set1_epi8(FIELD_BEGIN);
+    const __m128i end16 = _mm_set1_epi8(FIELD_END);
+    const __m128i quote16 = _mm_set1_epi8(STRING_QUOTE);
+    for (; i + 16 <= length; i += 16) {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&line[i]));
+        __m128i found =
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chars, begin16), _mm_cmpeq_epi8(chars, end16)),
+                         _mm_cmpeq_epi8(chars, quote16));
+        unsigned mask = _mm_movemask_epi8(found);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+#endif
+
+    for (; i < length; i++) {
+        char c = line[i];
+        if (c == FIELD_BEGIN || c == FIELD_END || c == STRING_QUOTE) {
+            return i;
+        }
+    }
+    return length;
+}
+
 /**
  * Creates a new SorParser with the given parameters.
  * @param file The file to read from.
@@ -287,6 +341,33 @@ SorParser::SorParser(FILE* file, size_t file_start, size_t file_end, size_t file
     _num_columns = 0;
 }
 
+/**
+ * Creates a new SorParser without a file or a schema. Its schema is guessed with guessLines().
+ */
+SorParser::SorParser() : Object() {
+    _reader = nullptr;
+    _columns = nullptr;
+    _typeGuesses = nullptr;
+    _num_columns = 0;
+}
+
+/**
+ * Creates a new SorParser for an already known schema. It has no file of its own and is
+ * given lines through parseLine(), so several parsers can work on parts of the same file.
+ * @param types The type of each column, copied
+ * @param num_columns The number of columns
+ */
+SorParser::SorParser(const ColumnType* types, size_t num_columns) : Object() {
+    _reader = nullptr;
+    _num_columns = num_columns;
+    _typeGuesses = new ColumnType[num_columns];
+    _columns = new ColumnSet(num_columns);
+    for (size_t i = 0; i < num_columns; i++) {
+        _typeGuesses[i] = types[i];
+        _columns->initializeColumn(i, types[i]);
+    }
+}
+
 /**
  * Destructor for SorParser
  */
@@ -305,32 +386,30 @@ SorParser::~SorParser() {
  * using the type of the column.
  * @param slice The slice containing the data for this field
  * @param field_num The column index
- * @param columns The ColumnSet to add the data to
+ * @param sink Where to add the data, such as a ColumnSet
  */
-void SorParser::_appendField(StrSlice slice, size_t field_num, ColumnSet* columns) {
+void SorParser::_appendField(StrSlice slice, size_t field_num, FieldSink* sink) {
     slice.trim(SPACE);
 
-    BaseColumn* column = columns->getColumn(field_num);
-
     if (slice.getLength() == 0) {
-        column->appendMissing();
+        sink->appendMissing(field_num);
         return;
     }
 
-    switch (column->getType()) {
+    switch (_typeGuesses[field_num]) {
         case ColumnType::STRING:
             slice.trim(STRING_QUOTE);
             assert(slice.getLength() <= MAX_STRING);
-            dynamic_cast<StringColumn*>(column)->append(slice.toCString());
+            sink->appendString(field_num, slice.getChars(), slice.getLength());
             break;
         case ColumnType::INTEGER:
-            dynamic_cast<IntegerColumn*>(column)->append(slice.toInt());
+            sink->appendInt(field_num, slice.toInt());
             break;
         case ColumnType::FLOAT:
-            dynamic_cast<FloatColumn*>(column)->append(slice.toFloat());
+            sink->appendFloat(field_num, slice.toFloat());
             break;
         case ColumnType::BOOL:
-            dynamic_cast<BoolColumn*>(column)->append(slice.toInt() == 1);
+            sink->appendBool(field_num, slice.toInt() == 1);
             break;
         default:
             assert(false);
@@ -338,55 +417,87 @@ void SorParser::_appendField(StrSlice slice, size_t field_num, ColumnSet* column
 }
 
 /**
- * Tries to guess or update the guess for the given column index given a field contained in the
- * given StrSlice.
- * @param slice The slice to use
- * @param field_num The column index
+ * Guesses the type of a single field. Fields made up only of numeric chars are floats when they
+ * have a dot, and otherwise bools when they are 0 or 1 and integers if not. Anything else is a
+ * string.
+ * @param slice The slice containing the field, trimmed of spaces
+ * @return The guessed type, UNKNOWN for an empty field
  */
-void SorParser::_guessFieldType(StrSlice slice, size_t field_num) {
-    slice.trim(SPACE);
+ColumnType SorParser::guessType(StrSlice slice) {
     if (slice.getLength() == 0) {
-        return;
+        return ColumnType::UNKNOWN;
     }
 
-    // Check if the slice consists of only numeric chars
-    // and specifically whether it has a . (indicating float)
-    bool is_numeric = false;
     bool has_dot = false;
     for (size_t i = 0; i < slice.getLength(); i++) {
         char c = slice.getChar(i);
-        if (isNumeric(c)) {
-            is_numeric = true;
-            if (c == DOT) {
-                has_dot = true;
-            }
+        if (!isNumeric(c)) {
+            return ColumnType::STRING;
         }
+        has_dot = has_dot || c == DOT;
     }
-    // If the guess is already string, we can't change that because that means we have
-    // seen a non-numeric entry already
-    if (_typeGuesses[field_num] != ColumnType::STRING) {
-        if (is_numeric && !has_dot) {
-            // If it's an integer (not float), check if it's 0 or 1, which would indicate a
-            // bool column
-            int val = slice.toInt();
-            if ((val == 0 || val == 1) && _typeGuesses[field_num] != ColumnType::INTEGER &&
-                _typeGuesses[field_num] != ColumnType::FLOAT) {
-                // Only keep the bool column guess if we haven't already guessed integer or
-                // float (because that means we have seen non-bool values)
-                _typeGuesses[field_num] = ColumnType::BOOL;
-            } else if (_typeGuesses[field_num] != ColumnType::FLOAT) {
-                // Use integer guess only if we didn't already guess float (which could not be
-                // parsed as integer)
-                _typeGuesses[field_num] = ColumnType::INTEGER;
-            }
-        } else if (is_numeric && has_dot) {
-            // If there's a dot, this must be a float column
-            _typeGuesses[field_num] = ColumnType::FLOAT;
-        } else {
-            // If there are non-numeric chars then this must be a string column
-            _typeGuesses[field_num] = ColumnType::STRING;
+
+    if (has_dot) {
+        return ColumnType::FLOAT;
+    }
+    int val = slice.toInt();
+    return val == 0 || val == 1 ? ColumnType::BOOL : ColumnType::INTEGER;
+}
+
+/**
+ * Combines two guesses for the same column into the narrowest type that can hold both. Types
+ * widen from UNKNOWN to BOOL, INTEGER, FLOAT and finally STRING.
+ * @param a The first guess
+ * @param b The second guess
+ * @return The combined guess
+ */
+ColumnType SorParser::mergeTypes(ColumnType a, ColumnType b) {
+    auto rank = [](ColumnType type) {
+        switch (type) {
+            case ColumnType::UNKNOWN:
+                return 0;
+            case ColumnType::BOOL:
+                return 1;
+            case ColumnType::INTEGER:
+                return 2;
+            case ColumnType::FLOAT:
+                return 3;
+            default:
+                return 4;
         }
+    };
+    return rank(a) >= rank(b) ? a : b;
+}
+
+/**
+ * Widens the type guesses to the given number of columns, new columns start as UNKNOWN.
+ * @param num_columns The new number of columns, smaller values are ignored
+ */
+void SorParser::_growGuesses(size_t num_columns) {
+    if (num_columns <= _num_columns) {
+        return;
+    }
+
+    ColumnType* guesses = new ColumnType[num_columns];
+    for (size_t i = 0; i < num_columns; i++) {
+        guesses[i] = i < _num_columns ? _typeGuesses[i] : ColumnType::UNKNOWN;
     }
+    delete[] _typeGuesses;
+    _typeGuesses = guesses;
+    _num_columns = num_columns;
+}
+
+/**
+ * Tries to guess or update the guess for the given column index given a field contained in the
+ * given StrSlice. Columns past the ones seen so far are added.
+ * @param slice The slice to use
+ * @param field_num The column index
+ */
+void SorParser::_guessFieldType(StrSlice slice, size_t field_num) {
+    _growGuesses(field_num + 1);
+
+    slice.trim(SPACE);
+    _typeGuesses[field_num] = mergeTypes(_typeGuesses[field_num], guessType(slice));
 }
 
 /**
@@ -394,9 +505,20 @@ void SorParser::_guessFieldType(StrSlice slice, size_t field_num) {
  * given parsing mode.
  * @param line The line to scan/parse
  * @param mode The mode to use
- * @param columns The data representation to update
+ * @param sink The data representation to update
  */
-size_t SorParser::_scanLine(const char* line, ParserMode mode, ColumnSet* columns) {
+size_t SorParser::_scanLine(const char* line, ParserMode mode, FieldSink* sink) {
+    return _scanLine(line, strlen(line), mode, sink);
+}
+
+/**
+ * Same as above for a line of the given length, which need not be null terminated.
+ * @param line The line to scan/parse
+ * @param length The number of chars in the line
+ * @param mode The mode to use
+ * @param sink The data representation to update
+ */
+size_t SorParser::_scanLine(const char* line, size_t length, ParserMode mode, FieldSink* sink) {
     size_t num_fields = 0;
     size_t this_field_start = 0;
     bool in_field = false;
@@ -405,7 +527,9 @@ size_t SorParser::_scanLine(const char* line, ParserMode mode, ColumnSet* column
     // Iterate over the line, create slices for each detected field, and call either
     // _guessFieldType for ParserMode::DETECT_SCHEMA or _appendField for ParserMode::PARSE_FILE
     // for ParserMode::DETECT_NUM_COLUMNS we simply return the number of fields we saw
-    for (size_t i = 0; i < strlen(line); i++) {
+    // Only delimiters and quotes change the state, so everything in between is skipped
+    for (size_t i = findDelimiter(line, 0, length); i < length;
+         i = findDelimiter(line, i + 1, length)) {
         char c = line[i];
         if (!in_field) {
             if (c == FIELD_BEGIN) {
@@ -419,8 +543,8 @@ size_t SorParser::_scanLine(const char* line, ParserMode mode, ColumnSet* column
             } else if (c == FIELD_END && !in_string) {
                 if (mode == ParserMode::DETECT_SCHEMA) {
                     _guessFieldType(StrSlice(line, this_field_start + 1, i), num_fields);
-                } else if (mode == ParserMode::PARSE_FILE) {
-                    _appendField(StrSlice(line, this_field_start + 1, i), num_fields, columns);
+                } else if (mode == ParserMode::PARSE_FILE && num_fields < _num_columns) {
+                    _appendField(StrSlice(line, this_field_start + 1, i), num_fields, sink);
                 }
                 in_field = false;
                 num_fields++;
@@ -438,39 +562,66 @@ size_t SorParser::_scanLine(const char* line, ParserMode mode, ColumnSet* column
 void SorParser::guessSchema() {
     assert(_columns == nullptr);
     assert(_typeGuesses == nullptr);
-    // Detect the row with the most fields in the first 500 lines
-    size_t max_columns = 0;
+
+    // Columns are counted and their types guessed in the same pass
     for (size_t i = 0; i < GUESS_SCHEMA_LINES; i++) {
         char* next_line = _reader->readLine();
         if (next_line == nullptr) {
             break;
         }
-        size_t num_columns = _scanLine(next_line, ParserMode::DETECT_NUM_COLUMNS, nullptr);
-        if (num_columns > max_columns) {
-            max_columns = num_columns;
-        }
+        _scanLine(next_line, ParserMode::DETECT_SCHEMA, nullptr);
         delete[] next_line;
     }
-    assert(max_columns != 0);
+    assert(_num_columns != 0);
 
-    // Guess the type for each column
-    _reader->reset();
-    _columns = new ColumnSet(max_columns);
-    _typeGuesses = new ColumnType[max_columns];
-    _num_columns = max_columns;
-    for (size_t i = 0; i < _num_columns; i++) {
-        _typeGuesses[i] = ColumnType::UNKNOWN;
+    initializeColumns();
+}
+
+/**
+ * Guesses the schema from up to max_lines lines of the given text in a single pass, widening
+ * the guesses made so far. Parsers guessing different parts of a file can be combined with
+ * mergeSchema().
+ * @param data The lines to guess from, need not be null terminated
+ * @param length The number of chars in data
+ * @param max_lines The maximum number of lines to look at
+ * @return The number of chars looked at
+ */
+size_t SorParser::guessLines(const char* data, size_t length, size_t max_lines) {
+    assert(_columns == nullptr);
+
+    size_t pos = 0;
+    for (size_t i = 0; i < max_lines && pos < length; i++) {
+        const char* newline = static_cast<const char*>(memchr(&data[pos], '\n', length - pos));
+        size_t end = newline == nullptr ? length : newline - data;
+
+        _scanLine(&data[pos], end - pos, ParserMode::DETECT_SCHEMA, nullptr);
+        pos = end + 1;
     }
 
-    for (size_t i = 0; i < GUESS_SCHEMA_LINES; i++) {
-        char* next_line = _reader->readLine();
-        if (next_line == nullptr) {
-            break;
-        }
-        _scanLine(next_line, ParserMode::DETECT_SCHEMA, nullptr);
-        delete[] next_line;
+    return pos < length ? pos : length;
+}
+
+/**
+ * Widens this parser's guesses with the guesses of another parser for the same file.
+ * @param other The other parser, must not have initialized its columns yet
+ */
+void SorParser::mergeSchema(SorParser* other) {
+    assert(_columns == nullptr);
+
+    _growGuesses(other->_num_columns);
+    for (size_t i = 0; i < other->_num_columns; i++) {
+        _typeGuesses[i] = mergeTypes(_typeGuesses[i], other->_typeGuesses[i]);
     }
+}
+
+/**
+ * Settles the guessed schema and creates the ColumnSet for it. Columns without any guess are
+ * assumed to be bools. Called by guessSchema(), or after guessLines() and mergeSchema().
+ */
+void SorParser::initializeColumns() {
+    assert(_columns == nullptr);
 
+    _columns = new ColumnSet(_num_columns);
     for (size_t i = 0; i < _num_columns; i++) {
         if (_typeGuesses[i] == ColumnType::UNKNOWN) {
             // Assume bool for anything we still don't have a guess for as per spec
@@ -487,6 +638,16 @@ void SorParser::guessSchema() {
 void SorParser::parseFile() {
     assert(_columns != nullptr);
 
+    parseFile(_columns);
+}
+
+/**
+ * Same as above, but appends the data to the given sink instead of this parser's ColumnSet.
+ * @param sink The data representation to update
+ */
+void SorParser::parseFile(FieldSink* sink) {
+    assert(_typeGuesses != nullptr);
+
     _reader->reset();
 
     char* line;
@@ -495,14 +656,26 @@ void SorParser::parseFile() {
         if (line == nullptr) {
             break;
         }
-        size_t scanned_fields = _scanLine(line, ParserMode::PARSE_FILE, _columns);
-        for (size_t i = scanned_fields; i < _num_columns; i++) {
-            _columns->getColumn(i)->appendMissing();
-        }
+        parseLine(line, strlen(line), sink);
         delete[] line;
     }
 }
 
+/**
+ * Appends the fields of a single line to the given columns, columns that the line has no
+ * field for get a missing entry. Fields past the last column are ignored.
+ * @param line The line to parse, need not be null terminated
+ * @param length The number of chars in the line
+ * @param sink The data representation to update, such as a ColumnSet
+ */
+void SorParser::parseLine(const char* line, size_t length, FieldSink* sink) {
+    size_t scanned_fields = _scanLine(line, length, ParserMode::PARSE_FILE, sink);
+    for (size_t i = scanned_fields; i < _num_columns; i++) {
+        // an empty slice is appended as a missing entry
+        _appendField(StrSlice(line, 0, 0), i, sink);
+    }
+}
+
 /**
  * Gets the in-memory representation for the sor data.
  * guessSchema() and parseFile() must be called before this function.
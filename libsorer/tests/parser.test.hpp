@@ -13,6 +13,7 @@
 #include <stdio.h>
 
 #include "sorer/column.h"
+#include "sorer/mapped.h"
 #include "sorer/parser.h"
 
 char* cwc_strdup(const char* src) {
@@ -167,3 +168,146 @@ TEST_F(FileTest, dataTest) {
     ASSERT_FALSE(strcol->isEntryPresent(1));
     ASSERT_FALSE(strcol->isEntryPresent(2));
 }
+
+TEST(MappedTest, openFailures) {
+    ne::MappedFile missing("no_such_file.sor");
+    ASSERT_FALSE(missing.isOpen());
+    ASSERT_EQ(0, missing.getSize());
+
+    // an empty file opens with no data
+    FILE* empty = fopen("empty.sor", "w");
+    ASSERT_NE(nullptr, empty);
+    fclose(empty);
+    ne::MappedFile file("empty.sor");
+    ASSERT_TRUE(file.isOpen());
+    ASSERT_EQ(0, file.getSize());
+    remove("empty.sor");
+}
+
+TEST(MappedTest, splitAndParse) {
+    ne::MappedFile file("data.sor");
+    ASSERT_TRUE(file.isOpen());
+    ASSERT_EQ(34, file.getSize());
+
+    // every segment starts at the beginning of a line
+    size_t bounds[4];
+    file.split(0, file.getSize(), 3, bounds);
+    ASSERT_EQ(0, bounds[0]);
+    ASSERT_EQ(file.getSize(), bounds[3]);
+    for (size_t i = 1; i < 3; i++) {
+        ASSERT_LE(bounds[i - 1], bounds[i]);
+        ASSERT_EQ('\n', file.getData()[bounds[i] - 1]);
+    }
+    ASSERT_EQ(14, file.nextLine(1));
+    ASSERT_EQ(14, file.nextLine(14));
+
+    ne::ColumnType types[] = {ne::ColumnType::BOOL, ne::ColumnType::INTEGER,
+                              ne::ColumnType::STRING};
+    ne::SorParser parser(types, 3);
+    for (size_t i = 0; i < 3; i++) {
+        parser.parseLine(file.getData() + bounds[i], bounds[i + 1] - bounds[i],
+                         parser.getColumnSet());
+    }
+
+    ne::ColumnSet* set = parser.getColumnSet();
+    ne::IntegerColumn* intcol = dynamic_cast<ne::IntegerColumn*>(set->getColumn(1));
+    ne::StringColumn* strcol = dynamic_cast<ne::StringColumn*>(set->getColumn(2));
+    ASSERT_EQ(3, intcol->getLength());
+    ASSERT_EQ(12, intcol->getEntry(1));
+    ASSERT_STREQ("hi", strcol->getEntry(0));
+    ASSERT_FALSE(strcol->isEntryPresent(2));
+}
+
+// Records what a parser hands to its sink
+class CountingSink : public ne::FieldSink {
+   public:
+    size_t strings = 0;
+    size_t missing = 0;
+    int int_sum = 0;
+
+    void appendString(size_t column, const char* str, size_t length) override {
+        strings++;
+        ASSERT_EQ(0, strncmp("hi", str, length));
+    }
+    void appendInt(size_t column, int value) override { int_sum += value; }
+    void appendFloat(size_t column, float value) override {}
+    void appendBool(size_t column, bool value) override {}
+    void appendMissing(size_t column) override { missing++; }
+};
+
+TEST_F(FileTest, sinkTest) {
+    LoadFile("data.sor");
+
+    ne::SorParser parser(file, 0, fsize, fsize);
+    parser.guessSchema();
+
+    CountingSink sink;
+    parser.parseFile(&sink);
+
+    ASSERT_EQ(1, sink.strings);
+    ASSERT_EQ(2, sink.missing);
+    ASSERT_EQ(23 + 12 + 1, sink.int_sum);
+}
+
+TEST(ParserTest, findDelimiter) {
+    // long enough to cross several vector widths
+    const char* line = "<1>                                      <\"a > b\">                  <2.5>";
+    size_t length = strlen(line);
+
+    ASSERT_EQ(0, ne::SorParser::findDelimiter(line, 0, length));
+    ASSERT_EQ(2, ne::SorParser::findDelimiter(line, 1, length));
+    ASSERT_EQ(41, ne::SorParser::findDelimiter(line, 3, length));
+    ASSERT_EQ(length - 1, ne::SorParser::findDelimiter(line, length - 4, length));
+    ASSERT_EQ(length, ne::SorParser::findDelimiter(line, length, length));
+    ASSERT_EQ(3, ne::SorParser::findDelimiter("abc", 0, 3));
+
+    ne::ColumnType types[] = {ne::ColumnType::INTEGER, ne::ColumnType::STRING,
+                              ne::ColumnType::FLOAT};
+    ne::SorParser parser(types, 3);
+    parser.parseLine(line, length, parser.getColumnSet());
+
+    ne::ColumnSet* set = parser.getColumnSet();
+    ASSERT_STREQ("a > b", dynamic_cast<ne::StringColumn*>(set->getColumn(1))->getEntry(0));
+    ASSERT_EQ(2.5f, dynamic_cast<ne::FloatColumn*>(set->getColumn(2))->getEntry(0));
+}
+
+TEST(ParserTest, parseNumbers) {
+    ASSERT_EQ(12.5f, (ne::StrSlice{"+12.5", 0, 5}.toFloat()));
+    ASSERT_EQ(-0.25f, (ne::StrSlice{"-.25", 0, 4}.toFloat()));
+    ASSERT_EQ(1500.0f, (ne::StrSlice{"1.5e3", 0, 5}.toFloat()));
+    ASSERT_EQ(0.0f, (ne::StrSlice{"abc", 0, 3}.toFloat()));
+    ASSERT_EQ(0, (ne::StrSlice{"-", 0, 1}.toInt()));
+    ASSERT_EQ(17, (ne::StrSlice{"17x", 0, 3}.toInt()));
+}
+
+TEST(ParserTest, guessSchemaSamples) {
+    ASSERT_EQ(ne::ColumnType::BOOL, ne::SorParser::guessType(ne::StrSlice{"1", 0, 1}));
+    ASSERT_EQ(ne::ColumnType::INTEGER, ne::SorParser::guessType(ne::StrSlice{"-12", 0, 3}));
+    ASSERT_EQ(ne::ColumnType::FLOAT, ne::SorParser::guessType(ne::StrSlice{"1.5", 0, 3}));
+    // a digit does not make a string numeric
+    ASSERT_EQ(ne::ColumnType::STRING, ne::SorParser::guessType(ne::StrSlice{"row 0", 0, 5}));
+    ASSERT_EQ(ne::ColumnType::UNKNOWN, ne::SorParser::guessType(ne::StrSlice{"", 0, 0}));
+
+    ASSERT_EQ(ne::ColumnType::FLOAT,
+              ne::SorParser::mergeTypes(ne::ColumnType::INTEGER, ne::ColumnType::FLOAT));
+    ASSERT_EQ(ne::ColumnType::BOOL,
+              ne::SorParser::mergeTypes(ne::ColumnType::BOOL, ne::ColumnType::UNKNOWN));
+
+    // each sample only sees part of the schema
+    const char* first = "<1> <2>\n<0> <>\n";
+    const char* second = "<1> <2.5> <hi>\n";
+    ne::SorParser a;
+    ne::SorParser b;
+    ASSERT_EQ(strlen(first), a.guessLines(first, strlen(first), 10));
+    ASSERT_EQ(8, b.guessLines(first, strlen(first), 1));
+    b.guessLines(second, strlen(second), 10);
+    ASSERT_EQ(2, a._num_columns);
+    ASSERT_EQ(3, b._num_columns);
+
+    a.mergeSchema(&b);
+    a.initializeColumns();
+    ASSERT_EQ(3, a._num_columns);
+    ASSERT_EQ(ne::ColumnType::BOOL, a.getColumnSet()->getColumn(0)->getType());
+    ASSERT_EQ(ne::ColumnType::FLOAT, a.getColumnSet()->getColumn(1)->getType());
+    ASSERT_EQ(ne::ColumnType::STRING, a.getColumnSet()->getColumn(2)->getType());
+}
@@ -1,4 +1,7 @@
+#include <sys/stat.h>
+
 #include "application.hpp"
+#include "columnfile.hpp"
 #include "dataframe.hpp"
 #include "helper.hpp"
 #include "row.hpp"
@@ -204,11 +207,11 @@ class Linus : public Application {
         Key cK("comts");
         if (index == 0) {
             pln("Reading...");
-            projects = DataFrame::fromFile(PROJ, pK, &kv);
+            projects = load(PROJ, pK);
             p("    ").p(projects->nrows()).pln(" projects");
-            users = DataFrame::fromFile(USER, uK, &kv);
+            users = load(USER, uK);
             p("    ").p(users->nrows()).pln(" users");
-            commits = DataFrame::fromFile(COMM, cK, &kv);
+            commits = load(COMM, cK);
             p("    ").p(commits->nrows()).pln(" commits");
             // This dataframe contains the id of Linus.
             DataFrame::fromScalar(Key("users-0-0"), &kv, LINUS);
@@ -221,6 +224,35 @@ class Linus : public Application {
         pSet = new Set(projects);
     }
 
+    /** Whether the binary copy was written after the file last changed. A
+     *  copy whose file is gone is still used. **/
+    static bool isFresh(const char* file, const std::string& binary) {
+        struct stat source, copy;
+        if (stat(binary.c_str(), &copy)) return false;
+        if (stat(file, &source)) return true;
+        if (copy.st_mtim.tv_sec != source.st_mtim.tv_sec)
+            return copy.st_mtim.tv_sec > source.st_mtim.tv_sec;
+        return copy.st_mtim.tv_nsec >= source.st_mtim.tv_nsec;
+    }
+
+    /** Loads one of the input files, from the binary copy saved next to it by
+     *  an earlier run if it is up to date, so that restarts skip parsing. **/
+    DFPtr load(const char* file, Key& key) {
+        std::string binary = std::string(file) + ".eau2";
+        if (isFresh(file, binary)) {
+            ColumnFile saved(binary.c_str());
+            if (saved.isOpen()) {
+                DFPtr df = saved.dataFrame();
+                kv.push(key, df);
+                return df;
+            }
+        }
+
+        DFPtr df = DataFrame::fromFile(file, key, &kv);
+        if (df) ColumnFile::write(*df, binary.c_str());
+        return df;
+    }
+
     /** Performs a step of the linus calculation. It operates over the three
      *  datafrrames (projects, users, commits), the sets of tagged users and
      *  projects, and the users added in the previous round. */